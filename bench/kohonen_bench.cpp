@@ -0,0 +1,401 @@
+// Benchmarks de kohonen_visualizer. Usan datos sintéticos, así que no hacen
+// falta los ficheros de MNIST. Para obtener JSON comparable entre versiones:
+//
+//   ./kohonen_bench --benchmark_out=bench.json --benchmark_out_format=json
+//
+// Contadores: neurons/s y samples/s son tasas; ns_per_neuron es el tiempo
+// medio de una distancia completa dentro de la búsqueda de BMU.
+
+#include "ApproxBMUSearch.hpp"
+#include "BMUSearch.hpp"
+#include "BatchMapper.hpp"
+#include "GrowingSom.hpp"
+#include "IdxDataset.hpp"
+#include "KohonenNetwork.hpp"
+#include "MNISTLoader.hpp"
+#include "PrototypeImage.hpp"
+#include "QuantizedCodebook.hpp"
+#include "TextureAtlas.hpp"
+#include "UpdateKernel.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr int kInputDim = 28 * 28;
+
+std::vector<Vector> syntheticSamples(int count, int dim, unsigned seed = 42) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    std::vector<Vector> samples(count, Vector(dim));
+    for (auto& s : samples) {
+        for (auto& v : s) v = uniform(rng);
+    }
+    return samples;
+}
+
+// Fichero IDX3 sintético con el mismo formato que train-images.idx3-ubyte.
+class SyntheticIdxFile {
+public:
+    SyntheticIdxFile(int count, int rows, int cols) {
+        char name[] = "/tmp/kohonen_bench_XXXXXX";
+        int fd = mkstemp(name);
+        if (fd >= 0) close(fd);
+        path_ = name;
+
+        std::ofstream file(path_, std::ios::binary);
+        uint32_t header[4] = {0x00000803u, static_cast<uint32_t>(count),
+                              static_cast<uint32_t>(rows), static_cast<uint32_t>(cols)};
+        for (uint32_t h : header) {
+            uint32_t be = __builtin_bswap32(h);
+            file.write(reinterpret_cast<const char*>(&be), 4);
+        }
+        std::mt19937 rng(7);
+        std::vector<char> pixels(static_cast<std::size_t>(count) * rows * cols);
+        for (auto& p : pixels) p = static_cast<char>(rng() & 0xff);
+        file.write(pixels.data(), pixels.size());
+    }
+    ~SyntheticIdxFile() { std::remove(path_.c_str()); }
+
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+};
+
+SimdLevel levelArg(int64_t arg) {
+    return static_cast<SimdLevel>(arg);
+}
+
+void setLevelLabel(benchmark::State& state, SimdLevel requested) {
+    BMUSearch search(requested);
+    state.SetLabel(BMUSearch::simdLevelName(search.level()));
+}
+
+}
+
+// Distancia al cuadrado de una muestra a un único prototipo.
+static void BM_SquaredDistance(benchmark::State& state) {
+    SimdLevel level = levelArg(state.range(0));
+    srand(1);
+    Kohonen3D net(1, 1, 1, kInputDim);
+    auto samples = syntheticSamples(1, kInputDim);
+    BMUSearch search(level);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(search.find(net.getCodebook(), samples[0].data()));
+    }
+    setLevelLabel(state, level);
+    state.SetBytesProcessed(state.iterations() * kInputDim * sizeof(float) * 2);
+}
+BENCHMARK(BM_SquaredDistance)->DenseRange(0, 3);
+
+// Búsqueda exhaustiva de BMU: args = (lado de la red, nivel SIMD).
+static void BM_BMUSearch(benchmark::State& state) {
+    int side = static_cast<int>(state.range(0));
+    SimdLevel level = levelArg(state.range(1));
+    srand(1);
+    Kohonen3D net(side, side, side, kInputDim);
+    auto samples = syntheticSamples(64, kInputDim);
+    BMUSearch search(level);
+    std::size_t k = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(search.find(net.getCodebook(), samples[k++ % samples.size()].data()));
+    }
+    setLevelLabel(state, level);
+    double neurons = static_cast<double>(net.getNumNeurons());
+    state.counters["neurons/s"] = benchmark::Counter(neurons, benchmark::Counter::kIsIterationInvariantRate);
+    state.counters["ns_per_neuron"] = benchmark::Counter(neurons * 1e-9,
+        benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+BENCHMARK(BM_BMUSearch)
+    ->ArgsProduct({{5, 10, 20}, {0, 1, 2, 3}})
+    ->Unit(benchmark::kMicrosecond);
+
+// BMU con QuantizedCodebook frente a fp32 (BMUSearch al mejor nivel):
+// args = (lado de la red, 0 = fp32, 1 = int8, 2 = int8 con entrada en bytes,
+// 3 = fp16).
+static void BM_QuantizedFind(benchmark::State& state) {
+    int side = static_cast<int>(state.range(0));
+    int variant = static_cast<int>(state.range(1));
+    srand(1);
+    Kohonen3D net(side, side, side, kInputDim);
+    auto samples = syntheticSamples(64, kInputDim);
+    std::vector<std::vector<uint8_t>> bytes(samples.size(), std::vector<uint8_t>(kInputDim));
+    for (std::size_t s = 0; s < samples.size(); s++) {
+        for (int j = 0; j < kInputDim; j++) bytes[s][j] = static_cast<uint8_t>(samples[s][j] * 255.0f);
+    }
+    QuantizedCodebook quantized(net, variant == 3 ? QuantFormat::Float16 : QuantFormat::Int8);
+    BMUSearch exact;
+    std::size_t k = 0;
+    for (auto _ : state) {
+        std::size_t s = k++ % samples.size();
+        if (variant == 0) benchmark::DoNotOptimize(exact.find(net.getCodebook(), samples[s].data()));
+        else if (variant == 2) benchmark::DoNotOptimize(quantized.find(bytes[s].data()));
+        else benchmark::DoNotOptimize(quantized.find(samples[s].data()));
+    }
+    const char* labels[] = {"fp32 ", "int8 ", "int8 bytes ", "fp16 "};
+    std::size_t codebook_bytes = variant == 0 ? net.getCodebook().sizeBytes() : quantized.sizeBytes();
+    state.SetLabel(std::string(labels[variant]) + std::to_string(codebook_bytes / 1024) + " KiB");
+    double neurons = static_cast<double>(net.getNumNeurons());
+    state.counters["neurons/s"] = benchmark::Counter(neurons, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_QuantizedFind)
+    ->ArgsProduct({{10, 20}, {0, 1, 2, 3}})
+    ->Unit(benchmark::kMicrosecond);
+
+// Actualización de las vecinas de una BMU en el centro de una red de
+// 10x10x10: args = (radio del vecindario, nivel SIMD, 1 = puntuar además la
+// muestra siguiente).
+static void BM_NeighborUpdate(benchmark::State& state) {
+    float radius = static_cast<float>(state.range(0));
+    SimdLevel level = levelArg(state.range(1));
+    bool score = state.range(2) != 0;
+    srand(1);
+    Kohonen3D net(10, 10, 10, kInputDim);
+    WeightMatrix weights = net.getCodebook();
+    auto samples = syntheticSamples(2, kInputDim);
+    NeighborhoodStencil stencil(radius);
+    std::vector<NeighborUpdate> updates;
+    stencil.forEach(5, 5, 5, 10, 10, 10, [&](int i, float h) { updates.push_back({i, 0.01f * h}); });
+    UpdateKernel kernel(level);
+    int count = static_cast<int>(updates.size());
+    for (auto _ : state) {
+        if (score) {
+            benchmark::DoNotOptimize(kernel.applyAndScore(weights, samples[0].data(), updates.data(), count,
+                                                          samples[1].data()));
+        } else {
+            kernel.apply(weights, samples[0].data(), updates.data(), count);
+        }
+        benchmark::DoNotOptimize(weights.data());
+    }
+    state.SetLabel(BMUSearch::simdLevelName(kernel.level()));
+    state.counters["rows"] = count;
+    state.SetBytesProcessed(state.iterations() * count * kInputDim * sizeof(float) * 2);
+}
+BENCHMARK(BM_NeighborUpdate)
+    ->ArgsProduct({{1, 3}, {0, 1, 2, 3}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+// Inferencia por lotes (BatchMapper) de 4096 muestras sobre una red de
+// 10x10x10: args = (dimensión, nivel SIMD, hilos). Con hilos = 0 se compara
+// contra el bucle de BMUSearch::find muestra a muestra en un solo hilo.
+static void BM_MapBatch(benchmark::State& state) {
+    int dim = static_cast<int>(state.range(0));
+    SimdLevel level = levelArg(state.range(1));
+    int threads = static_cast<int>(state.range(2));
+    srand(1);
+    Kohonen3D net(10, 10, 10, dim);
+    auto samples = syntheticSamples(4096, dim);
+    BatchMapper mapper(net.getCodebook(), level);
+    BMUSearch search(level);
+    MappingOptions options;
+    options.threads = threads;
+    for (auto _ : state) {
+        if (threads == 0) {
+            for (const auto& x : samples) benchmark::DoNotOptimize(search.find(net.getCodebook(), x.data()));
+        } else {
+            benchmark::DoNotOptimize(mapper.map(samples, options));
+        }
+    }
+    setLevelLabel(state, level);
+    state.counters["samples/s"] = benchmark::Counter(static_cast<double>(samples.size()),
+                                                     benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_MapBatch)
+    ->ArgsProduct({{128, 512, kInputDim}, {2, 3}, {0, 1, 4}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Búsqueda aproximada (pirámide + hill-climb) frente a exhaustiva en redes
+// grandes con entradas de 64 dimensiones: args = (lado, 0=exhaustiva 1=aproximada).
+static void BM_ApproxBMUSearch(benchmark::State& state) {
+    int side = static_cast<int>(state.range(0));
+    const int dim = 64;
+    srand(1);
+    Kohonen3D net(side, side, side, dim);
+    auto samples = syntheticSamples(64, dim);
+    ApproxBMUSearch approx(net.getCodebook(), net.getLattice());
+    BMUSearch exact;
+    bool use_approx = state.range(1) != 0;
+    std::size_t k = 0;
+    int hint = -1;
+    for (auto _ : state) {
+        const float* x = samples[k++ % samples.size()].data();
+        BMUResult r = use_approx ? approx.find(x, hint) : exact.find(net.getCodebook(), x);
+        hint = r.index;
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetLabel(use_approx ? "approximate" : "exhaustive");
+    state.counters["neurons/s"] = benchmark::Counter(net.getNumNeurons(), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_ApproxBMUSearch)
+    ->ArgsProduct({{20, 40}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+// Descenso por la jerarquía de un GrowingSom frente a búsqueda exhaustiva
+// sobre un codebook plano con las mismas neuronas (las filas de todos sus
+// mapas): arg 0 = jerarquía, 1 = plano.
+static void BM_GrowingFind(benchmark::State& state) {
+    const int dim = 64;
+    static GrowingSom som = [] {
+        GrowingOptions options;
+        options.depth = 0.1f;
+        GrowingSom g(options);
+        g.train(syntheticSamples(4000, dim));
+        return g;
+    }();
+    auto samples = syntheticSamples(64, dim, 7);
+    WeightMatrix flat(som.totalNeurons(), dim);
+    for (int m = 0, row = 0; m < som.mapCount(); m++) {
+        const WeightMatrix& codebook = som.getMap(m).getCodebook();
+        for (int i = 0; i < codebook.rows(); i++, row++) {
+            std::copy(codebook.row(i), codebook.row(i) + dim, flat.row(row));
+        }
+    }
+    BMUSearch exact;
+    bool hierarchical = state.range(0) == 0;
+    std::size_t k = 0;
+    for (auto _ : state) {
+        const float* x = samples[k++ % samples.size()].data();
+        if (hierarchical) {
+            benchmark::DoNotOptimize(som.find(x));
+        } else {
+            benchmark::DoNotOptimize(exact.find(flat, x));
+        }
+    }
+    state.SetLabel(std::string(hierarchical ? "hierarchy " : "flat ") + std::to_string(som.totalNeurons()) + " neurons");
+}
+BENCHMARK(BM_GrowingFind)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+// Una época completa de Kohonen3D::train: args = (lado, modo 0=online
+// 1=batch 2=hogwild).
+static void BM_TrainEpoch(benchmark::State& state) {
+    int side = static_cast<int>(state.range(0));
+    const TrainMode modes[] = {TrainMode::Online, TrainMode::Batch, TrainMode::Hogwild};
+    const char* labels[] = {"online", "batch", "hogwild"};
+    TrainOptions options;
+    options.mode = modes[state.range(1)];
+    auto samples = syntheticSamples(1000, kInputDim);
+    std::streambuf* old = std::cout.rdbuf(nullptr);   // silenciar "Epoch N/M done."
+    for (auto _ : state) {
+        state.PauseTiming();
+        srand(1);
+        Kohonen3D net(side, side, side, kInputDim);
+        state.ResumeTiming();
+        net.train(samples, 1, 0.1f, 3.0f, options);
+        benchmark::DoNotOptimize(net.getCodebook().data());
+    }
+    std::cout.rdbuf(old);
+    state.SetLabel(labels[state.range(1)]);
+    state.counters["samples/s"] = benchmark::Counter(static_cast<double>(samples.size()),
+                                                     benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_TrainEpoch)
+    ->ArgsProduct({{5, 10}, {0, 1, 2}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Hogwild frente a la regla secuencial en 3 épocas sobre 10x10x10:
+// args = (hilos, muestras por hilo entre sincronizaciones). qe_drift es la
+// diferencia relativa (%) del error de cuantización final respecto a la
+// red entrenada en secuencia con la misma semilla, y speedup el cociente
+// entre el tiempo de esa red (TrainMode::Online) y el de Hogwild.
+static void BM_HogwildDrift(benchmark::State& state) {
+    auto samples = syntheticSamples(2000, 64);
+    auto finalQe = [&](const Kohonen3D& net) {
+        double total = 0.0;
+        for (const MappedSample& m : net.mapBatch(samples)) total += m.quantizationError;
+        return total / samples.size();
+    };
+    auto seconds = [](std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+    TrainOptions options;
+    options.logEpochs = false;
+    // la mejor de tres, para que speedup no dependa de una sola medida
+    Kohonen3D reference(10, 10, 10, 64);
+    double online_seconds = 0.0;
+    for (int run = 0; run < 3; run++) {
+        srand(1);
+        reference = Kohonen3D(10, 10, 10, 64);
+        auto start = std::chrono::steady_clock::now();
+        reference.train(samples, 3, 0.3f, 4.0f, options);
+        online_seconds = run == 0 ? seconds(start) : std::min(online_seconds, seconds(start));
+    }
+
+    options.mode = TrainMode::Hogwild;
+    options.threads = static_cast<int>(state.range(0));
+    options.syncInterval = static_cast<int>(state.range(1));
+    double qe = 0.0, hogwild_seconds = 0.0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        srand(1);
+        Kohonen3D net(10, 10, 10, 64);
+        state.ResumeTiming();
+        auto start = std::chrono::steady_clock::now();
+        net.train(samples, 3, 0.3f, 4.0f, options);
+        hogwild_seconds += seconds(start);
+        state.PauseTiming();
+        qe = finalQe(net);
+        state.ResumeTiming();
+    }
+    state.counters["qe_drift"] = 100.0 * (qe / finalQe(reference) - 1.0);
+    state.counters["speedup"] = online_seconds * state.iterations() / hogwild_seconds;
+    state.counters["samples/s"] = benchmark::Counter(3.0 * samples.size(), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_HogwildDrift)
+    ->ArgsProduct({{1, 2, 4, 8}, {16, 256}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Carga de imágenes IDX a vectores float (ruta usada por main.cpp).
+static void BM_LoadImages(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    SyntheticIdxFile file(count, 28, 28);
+    for (auto _ : state) {
+        auto images = MNISTDataset::loadImages(file.path());
+        benchmark::DoNotOptimize(images.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(count) * kInputDim);
+    state.counters["samples/s"] = benchmark::Counter(count, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_LoadImages)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+// Apertura de un IDX con mmap (sin conversión).
+static void BM_MapIdx(benchmark::State& state) {
+    SyntheticIdxFile file(static_cast<int>(state.range(0)), 28, 28);
+    for (auto _ : state) {
+        IdxDataset dataset(file.path());
+        benchmark::DoNotOptimize(dataset.rawSample(0));
+    }
+}
+BENCHMARK(BM_MapIdx)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+// Preparación del atlas de KohonenVisualizer::initNeurons sin GL.
+static void BM_PrepareTextures(benchmark::State& state) {
+    int side = static_cast<int>(state.range(0));
+    srand(1);
+    Kohonen3D net(side, side, side, kInputDim);
+    std::vector<unsigned char> pixels(static_cast<std::size_t>(kInputDim) * 3);
+    for (auto _ : state) {
+        TextureAtlas atlas(28, 28, net.getNumNeurons(), 8192);
+        for (int i = 0; i < net.getNumNeurons(); i++) {
+            prototypeToRGB(net.getWeight(i), 28, 28, pixels.data());
+            atlas.setTile(i, pixels.data());
+        }
+        benchmark::DoNotOptimize(atlas.pageData(0));
+    }
+    state.counters["neurons/s"] = benchmark::Counter(net.getNumNeurons(),
+                                                     benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_PrepareTextures)->Arg(10)->Arg(20)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Bloque de memoria de T alineado a 64 bytes (línea de caché / registro
+// AVX-512) e inicializado a cero. T debe ser trivialmente copiable.
+template <typename T>
+class AlignedBuffer {
+public:
+    static constexpr std::size_t kAlignment = 64;
+
+    AlignedBuffer() = default;
+    explicit AlignedBuffer(std::size_t count) : size_(count), data_(allocate(count)) {
+        if (data_) std::memset(data_.get(), 0, count * sizeof(T));
+    }
+
+    AlignedBuffer(const AlignedBuffer& other) : size_(other.size_), data_(allocate(other.size_)) {
+        if (data_) std::memcpy(data_.get(), other.data_.get(), size_ * sizeof(T));
+    }
+    AlignedBuffer& operator=(const AlignedBuffer& other) {
+        if (this != &other) {
+            AlignedBuffer tmp(other);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+    AlignedBuffer(AlignedBuffer&&) noexcept = default;
+    AlignedBuffer& operator=(AlignedBuffer&&) noexcept = default;
+
+    T* data() { return data_.get(); }
+    const T* data() const { return data_.get(); }
+    std::size_t size() const { return size_; }
+
+private:
+    struct Deleter {
+        void operator()(T* p) const { std::free(p); }
+    };
+
+    static T* allocate(std::size_t count) {
+        if (count == 0) return nullptr;
+        // aligned_alloc exige que el tamaño sea múltiplo del alineamiento
+        std::size_t bytes = (count * sizeof(T) + kAlignment - 1) / kAlignment * kAlignment;
+        void* p = std::aligned_alloc(kAlignment, bytes);
+        if (!p) throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+
+    std::size_t size_ = 0;
+    std::unique_ptr<T[], Deleter> data_;
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "BMUSearch.hpp"
+#include "LatticeTopology.hpp"
+#include <vector>
+
+struct ApproxBMUOptions {
+    int beamWidth = 4;          // nodos que se conservan en cada nivel de la pirámide (máx. 32)
+    int topLevelNeurons = 64;   // tamaño máximo del nivel más grueso
+    bool warmStart = true;      // hill-climb adicional desde la ganadora anterior
+    float minRecall = 0.98f;    // recall mínimo medido antes de volver a la búsqueda exhaustiva
+    int recallSamples = 256;    // muestras usadas para medir el recall
+};
+
+struct RecallReport {
+    int samples = 0;
+    float recall = 0.0f;             // fracción de BMUs idénticas a la búsqueda exhaustiva
+    float distanceRatio = 1.0f;      // distancia media aproximada / exacta
+};
+
+// Búsqueda aproximada de BMU en sublineal sobre redes grandes. Construye una
+// pirámide de sub-redes (cada nivel promedia bloques 2x2x2 del anterior),
+// desciende por ella conservando los beamWidth mejores nodos y refina el
+// resultado con un hill-climb sobre las vecinas de la red (las de
+// LatticeShape::adjacent, con vuelta en la toroidal y las de la celda en la
+// BCC), opcionalmente también desde la ganadora de la muestra anterior
+// (flujos correlacionados). La pirámide agrupa bloques de índices (x, y, z),
+// así que en la BCC sus niveles gruesos son sólo una aproximación.
+//
+// El nivel 0 es el codebook vivo: las distancias finales son exactas aunque
+// los niveles gruesos se hayan quedado desfasados desde el último rebuild().
+class ApproxBMUSearch {
+public:
+    ApproxBMUSearch(const WeightMatrix& codebook, const LatticeShape& lattice,
+                    const ApproxBMUOptions& options = ApproxBMUOptions());
+
+    // Recalcula los niveles gruesos a partir del codebook actual.
+    void rebuild();
+
+    // hint: ganadora anterior (o -1). Si el recall medido es insuficiente se
+    // usa directamente la búsqueda exhaustiva.
+    BMUResult find(const float* input, int hint = -1) const;
+    BMUResult findExact(const float* input) const;
+
+    // Compara con la búsqueda exhaustiva y activa el modo exacto si el recall
+    // queda por debajo de options.minRecall.
+    RecallReport measureRecall(const std::vector<const float*>& samples);
+
+    bool usingExhaustive() const { return exhaustive_; }
+    // find() aprovecha la pista (warm start activo y pirámide en uso).
+    bool usesHint() const { return options_.warmStart && !exhaustive_ && levels_.size() > 1; }
+    int levels() const { return static_cast<int>(levels_.size()); }
+
+private:
+    struct Level {
+        int sizeX, sizeY, sizeZ;
+        WeightMatrix prototypes;   // vacío en el nivel 0 (se usa el codebook)
+    };
+
+    struct Candidate {
+        int index;
+        float distance;
+    };
+
+    const WeightMatrix& levelWeights(int level) const;
+    float distance(int level, int index, const float* input) const;
+    BMUResult hillClimb(const float* input, BMUResult start) const;
+
+    const WeightMatrix& codebook_;
+    LatticeShape lattice_;
+    ApproxBMUOptions options_;
+    std::vector<Level> levels_;
+    BMUSearch search_;
+    bool exhaustive_ = false;
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "WeightMatrix.hpp"
+#include <cfloat>
+#include <cstdint>
+
+enum class SimdLevel {
+    Scalar,
+    SSE,
+    AVX2,
+    AVX512
+};
+
+struct BMUResult {
+    int index;
+    float distance;                   // distancia euclídea al cuadrado
+    // Segunda mejor neurona de la misma pasada (error topográfico); -1 si no
+    // se conoce (rango de una neurona, búsqueda aproximada).
+    int second = -1;
+    float secondDistance = FLT_MAX;
+
+    // Ofrece una neurona candidata. La mayoría no mejora a la segunda, así
+    // que el caso común cuesta una sola comparación.
+    void consider(int i, float d) {
+        if (!(d < secondDistance)) return;
+        if (d < distance) {
+            if (distance < FLT_MAX) {
+                second = index;
+                secondDistance = distance;
+            }
+            index = i;
+            distance = d;
+        } else if (i != index) {
+            second = i;
+            secondDistance = d;
+        }
+    }
+
+    // Combina con el resultado de otro rango de neuronas.
+    void merge(const BMUResult& other) {
+        if (other.distance < FLT_MAX) consider(other.index, other.distance);
+        if (other.second >= 0) consider(other.second, other.secondDistance);
+    }
+};
+
+// Búsqueda de la neurona ganadora (BMU). El kernel se elige en tiempo de
+// ejecución según las extensiones que reporte la CPU (CPUID), de modo que el
+// mismo binario funciona en cualquier máquina x86-64. La variable de entorno
+// KOHONEN_SIMD (scalar, sse, avx2, avx512) permite forzar un nivel inferior.
+class BMUSearch {
+public:
+    BMUSearch();
+    explicit BMUSearch(SimdLevel level);
+
+    BMUResult find(const WeightMatrix& codebook, const float* input) const;
+    BMUResult find(const WeightMatrix& codebook, const float* input, int begin, int end) const;
+    // Entrada en bytes (p.ej. una muestra IDX sin copiar); cada componente se
+    // normaliza como input[j] * scale dentro del propio kernel.
+    BMUResult find(const WeightMatrix& codebook, const uint8_t* input, float scale) const;
+
+    SimdLevel level() const { return level_; }
+
+    static SimdLevel detectSimdLevel();
+    static const char* simdLevelName(SimdLevel level);
+
+private:
+    using Kernel = BMUResult (*)(const float* weights, int stride, int cols,
+                                 int begin, int end, const float* input);
+    using ByteKernel = BMUResult (*)(const float* weights, int stride, int cols,
+                                     int begin, int end, const uint8_t* input, float scale);
+
+    SimdLevel level_;
+    Kernel kernel_;
+    ByteKernel byteKernel_;
+};
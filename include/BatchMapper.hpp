@@ -0,0 +1,63 @@
+#pragma once
+
+#include "BMUSearch.hpp"
+#include "SampleSource.hpp"
+#include "WeightMatrix.hpp"
+#include <vector>
+
+struct MappedSample {
+    int bmu;
+    int secondBmu;              // -1 si el codebook tiene una sola neurona
+    float quantizationError;    // ||x - w_bmu||, distancia euclídea (sin elevar al cuadrado)
+};
+
+struct MappingOptions {
+    int threads = 0;            // 0 = todos los núcleos
+    int sampleBlock = 64;       // muestras por tesela; se quedan en caché mientras pasan las neuronas
+    int neuronBlock = 512;      // neuronas por tesela; acota el búfer de puntuaciones
+    int chunkRows = 16384;      // sólo para SampleSource: muestras por bloque leído
+    int prefetchDepth = 2;      // sólo para SampleSource: bloques en vuelo
+};
+
+// Proyección de muestras sobre un mapa ya entrenado (inferencia). Las
+// distancias se calculan como en una GEMM, ||x||² - 2 x·w + ||w||², con las
+// normas ||w||² precalculadas: por teselas de sampleBlock x neuronBlock, cada
+// micro-kernel reutiliza las cargas de varias muestras y neuronas a la vez.
+// ||x||² no cambia el orden de las neuronas, así que sólo se usa al final:
+// las dos mejores se recalculan con la distancia exacta, lo que corrige su
+// orden y el error devuelto. Reduce el efecto de la cancelación numérica de
+// la forma expandida pero no lo elimina: si varias neuronas están casi
+// empatadas, la verdadera BMU puede quedar tercera y no recalcularse.
+//
+// Guarda una referencia al codebook: debe seguir vivo y sin cambios (si
+// cambia, hay que crear otro BatchMapper para refrescar las normas).
+class BatchMapper {
+public:
+    explicit BatchMapper(const WeightMatrix& codebook);
+    BatchMapper(const WeightMatrix& codebook, SimdLevel level);
+
+    // count muestras de codebook.cols() floats, separadas stride floats.
+    void map(const float* samples, int count, std::size_t stride, MappedSample* out,
+             const MappingOptions& options = MappingOptions()) const;
+    std::vector<MappedSample> map(const std::vector<std::vector<float>>& samples,
+                                  const MappingOptions& options = MappingOptions()) const;
+    // Sólo las muestras samples[indices[k]], sin copiarlas; el resultado k
+    // corresponde a indices[k].
+    std::vector<MappedSample> map(const std::vector<std::vector<float>>& samples, const std::vector<int>& indices,
+                                  const MappingOptions& options = MappingOptions()) const;
+    // Lee la fuente desde su posición actual hasta el final.
+    std::vector<MappedSample> map(SampleSource& source, const MappingOptions& options = MappingOptions()) const;
+
+    SimdLevel level() const { return level_; }
+
+private:
+    using DotKernel = void (*)(const float* x, int nx, const float* w, int nw, int stride, float* out, int ld);
+
+    void mapRows(const float* const* rows, int count, MappedSample* out, const MappingOptions& options) const;
+
+    const WeightMatrix& codebook_;
+    std::vector<float> norms_;   // ||w_i||²
+    SimdLevel level_;
+    DotKernel kernel_;
+    int kernelRows_;             // muestras por micro-kernel
+};
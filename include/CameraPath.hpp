@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Cámara orbital del visualizador: la red se aleja `zoom` unidades y se gira
+// angleX grados sobre X y luego angleY sobre Y, centrada en el origen.
+struct Camera {
+    float zoom = -15.0f;
+    float angleX = 20.0f;
+    float angleY = -30.0f;
+    float fovY = 45.0f;
+};
+
+// Plano cercano de la proyección, común a KohonenVisualizer y SoftwareRenderer.
+constexpr float kCameraNear = 0.1f;
+
+// Plano lejano para una red de size_x x size_y x size_z neuronas vista desde
+// `zoom`: se aleja lo necesario para que quepa toda la red, nunca por debajo
+// de 100 unidades. Los dos renderizadores lo usan para recortar igual.
+float cameraFarPlane(float zoom, int size_x, int size_y, int size_z);
+
+// Secuencia de cámaras, una por fotograma.
+class CameraPath {
+public:
+    CameraPath() = default;
+    explicit CameraPath(std::vector<Camera> frames);
+
+    // Vuelta completa (o de `degrees` grados) alrededor del eje Y.
+    static CameraPath orbit(const Camera& start, int frames, float degrees = 360.0f);
+
+    // Fotogramas clave en texto, una línea por clave:
+    //   frame zoom angleX angleY [fovY]
+    // Las líneas vacías o que empiezan por '#' se ignoran y una clave puede
+    // acabar en un comentario '#'; cualquier otro resto es un error. Las
+    // claves deben ir en orden de fotograma; entre ellas se interpola
+    // linealmente.
+    static CameraPath load(const std::string& filename);
+
+    int frameCount() const { return static_cast<int>(frames_.size()); }
+    const Camera& frame(int i) const { return frames_[i]; }
+
+private:
+    std::vector<Camera> frames_;
+};
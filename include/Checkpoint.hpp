@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+// Formato binario de checkpoint de Kohonen3D (versión 1):
+//
+//   [CheckpointHeader][relleno hasta weightsOffset][pesos]
+//
+// Los pesos se guardan tal cual están en memoria: neuronas x stride floats
+// (filas rellenadas con ceros), empezando en un desplazamiento alineado a 64
+// bytes. Así el fichero se puede proyectar con mmap y usar directamente como
+// codebook, sin parsear ni copiar.
+struct CheckpointHeader {
+    char magic[8];              // "KSOM3D\0\0"
+    uint32_t version;
+    uint32_t headerSize;        // sizeof(CheckpointHeader)
+    uint32_t byteOrder;         // kCheckpointByteOrder en la máquina que lo escribió
+    uint32_t topology;          // LatticeTopology
+    int32_t sizeX, sizeY, sizeZ;
+    int32_t inputDim;
+    int32_t stride;             // floats por fila
+    int32_t epoch;              // épocas completadas
+    int32_t totalEpochs;
+    float learningRateInitial;
+    float radiusInitial;
+    uint32_t schedule;          // 0 = lineal clásico; 1 = propio (ver Kohonen3D::setSchedule)
+    uint64_t weightsOffset;
+    uint64_t weightsBytes;
+};
+
+constexpr char kCheckpointMagic[8] = {'K', 'S', 'O', 'M', '3', 'D', '\0', '\0'};
+constexpr uint32_t kCheckpointVersion = 1;
+constexpr uint32_t kCheckpointByteOrder = 0x01020304u;
+constexpr uint64_t kCheckpointAlignment = 64;
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "BatchMapper.hpp"
+#include "BMUSearch.hpp"
+#include "KohonenNetwork.hpp"
+#include <vector>
+
+struct GrowingOptions {
+    int initialSize = 2;          // lado de la red con la que empieza cada mapa
+    // Un mapa deja de crecer cuando su error de cuantización medio baja de
+    // breadth * el de la neurona de la que cuelga (tau1 del GHSOM).
+    float breadth = 0.6f;
+    // Una neurona se expande en un mapa hijo si su error medio supera
+    // depth * QE0, el error de los datos respecto a su media (tau2). Con
+    // errores medios (no sumas) los valores útiles son mayores que los del
+    // GHSOM original.
+    float depth = 0.3f;
+    // También deja de crecer si un plano nuevo mejora el error en menos de
+    // esta fracción (el mapa ya está en el ruido de sus datos).
+    float minImprovement = 0.01f;
+    int epochsPerStep = 2;        // épocas entre inserciones de planos
+    float learningRate = 0.3f;
+    int maxNeuronsPerMap = 128;
+    int maxDepth = 3;             // niveles de la jerarquía, contando la raíz
+    int minSamplesPerMap = 30;    // neuronas con menos muestras no se expanden
+    int threads = 0;              // mapeo de muestras; 0 = todos los núcleos
+};
+
+struct HierarchicalBMU {
+    int map;                      // mapa hoja en el que termina el descenso
+    int neuron;                   // BMU dentro de ese mapa
+    int depth;                    // 0 = raíz
+    float quantizationError;      // ||x - w||, distancia euclídea
+};
+
+// SOM jerárquico creciente (GHSOM) sobre Kohonen3D. Cada mapa empieza con
+// initialSize^3 neuronas y, mientras su error sea alto, inserta un plano
+// entre la neurona de mayor error y su vecina más distinta (interpolando
+// los pesos); después las neuronas que siguen representando mal sus
+// muestras se expanden en un mapa hijo entrenado sólo con ellas.
+//
+// La búsqueda de BMU desciende la jerarquía: en cada nivel sólo se recorre
+// un mapa pequeño, así que el coste crece con la profundidad y no con el
+// total de neuronas. Los mapas son redes rectangulares.
+class GrowingSom {
+public:
+    explicit GrowingSom(const GrowingOptions& options = GrowingOptions());
+
+    void train(const std::vector<Vector>& data);
+
+    HierarchicalBMU find(const float* x) const;
+    // Descenso por niveles: las muestras de cada mapa se mapean en bloque
+    // con BatchMapper y se reparten entre sus hijos.
+    std::vector<HierarchicalBMU> map(const std::vector<Vector>& data,
+                                     const MappingOptions& options = MappingOptions()) const;
+
+    int mapCount() const { return static_cast<int>(maps_.size()); }
+    const Kohonen3D& root() const { return maps_.front().net; }
+    const Kohonen3D& getMap(int map) const { return maps_[map].net; }
+    int parentOf(int map) const { return maps_[map].parent; }
+    int depthOf(int map) const { return maps_[map].depth; }
+    // Mapa hijo de la neurona, o -1 si es una hoja.
+    int childOf(int map, int neuron) const { return maps_[map].children[neuron]; }
+    int totalNeurons() const;
+    int levels() const;
+    float dataQuantizationError() const { return qe0_; }
+
+private:
+    struct Node {
+        Kohonen3D net;
+        int parent;
+        int parentNeuron;
+        int depth;
+        std::vector<int> children;   // por neurona; -1 = hoja
+    };
+
+    // samples: índices en data de las muestras del mapa.
+    Kohonen3D growMap(const std::vector<Vector>& data, const std::vector<int>& samples, float parent_qe) const;
+    static Kohonen3D insertPlane(const Kohonen3D& net, int error_neuron, int neighbour);
+
+    GrowingOptions options_;
+    BMUSearch bmu_;
+    std::vector<Node> maps_;
+    float qe0_ = 0.0f;
+};
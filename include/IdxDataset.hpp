@@ -0,0 +1,70 @@
+#pragma once
+
+#include "MappedFile.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Códigos de tipo del formato IDX (tercer byte del número mágico).
+enum class IdxType : uint8_t {
+    UInt8 = 0x08,
+    Int8 = 0x09,
+    Int16 = 0x0B,
+    Int32 = 0x0C,
+    Float32 = 0x0D,
+    Float64 = 0x0E
+};
+
+// Vista no propietaria sobre los bytes de una muestra dentro del mapeo.
+class ByteView {
+public:
+    ByteView() = default;
+    ByteView(const uint8_t* data, int size) : data_(data), size_(size) {}
+
+    const uint8_t* data() const { return data_; }
+    int size() const { return size_; }
+    const uint8_t* begin() const { return data_; }
+    const uint8_t* end() const { return data_ + size_; }
+    uint8_t operator[](int i) const { return data_[i]; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    int size_ = 0;
+};
+
+// Fichero IDX (idx1, idx3, ... de cualquier tipo) proyectado con mmap. La
+// cabecera se valida una sola vez; las muestras se sirven directamente desde
+// el mapeo, de modo que sólo las páginas tocadas pasan a memoria residente.
+class IdxDataset {
+public:
+    explicit IdxDataset(const std::string& filename);
+
+    IdxType type() const { return type_; }
+    const std::vector<int>& dims() const { return dims_; }
+    int count() const { return dims_.empty() ? 0 : dims_[0]; }
+    int sampleSize() const { return sample_size_; }
+    std::size_t elementSize() const { return element_size_; }
+
+    // Bytes crudos de la muestra i (big-endian para tipos multibyte).
+    const uint8_t* rawSample(int i) const {
+        return data_ + static_cast<std::size_t>(i) * sample_size_ * element_size_;
+    }
+
+    // Muestra i sin copia; sólo válido para UInt8/Int8.
+    ByteView sample(int i) const;
+
+    // Convierte la muestra i a float multiplicando por scale.
+    void toFloat(int i, float* out, float scale = 1.0f) const;
+
+    static std::size_t elementSizeOf(IdxType type);
+
+private:
+    std::shared_ptr<MappedFile> file_;
+    IdxType type_;
+    std::vector<int> dims_;
+    int sample_size_ = 1;
+    std::size_t element_size_ = 1;
+    const uint8_t* data_ = nullptr;
+};
@@ -1,27 +1,222 @@
 #pragma once
 
+#include "WeightMatrix.hpp"
+#include "BMUSearch.hpp"
+#include "ApproxBMUSearch.hpp"
+#include "BatchMapper.hpp"
+#include "LatticeTopology.hpp"
+#include "Neighborhood.hpp"
+#include "SampleSource.hpp"
+#include "TrainingMetrics.hpp"
+#include "TrainingSchedule.hpp"
+#include "UpdateKernel.hpp"
+#include "WeightSnapshot.hpp"
+#include <atomic>
+#include <string>
 #include <vector>
 #include <cmath>
 #include <iostream>
 
 using Vector = std::vector<float>;
 
+enum class TrainMode {
+    Online,   // regla clásica: una actualización por muestra
+    Batch,    // batch SOM: una actualización del codebook por época
+    // Regla online en paralelo: cada hilo recorre su tramo de las muestras y
+    // escribe sus vecindarios en el codebook compartido fila a fila, cada
+    // una bajo su cerrojo (Hogwild); la BMU la busca en una copia propia que
+    // se refresca en cada sincronización. El resultado depende
+    // del entrelazado de los hilos. Siempre usa búsqueda exhaustiva
+    // (bmuStrategy no se aplica).
+    Hogwild
+};
+
+enum class BMUStrategy {
+    Exhaustive,
+    Approximate   // pirámide + hill-climb, ver ApproxBMUSearch
+};
+
+struct TrainOptions {
+    TrainMode mode = TrainMode::Online;
+    int threads = 0;   // modos Batch y Hogwild; 0 = todos los núcleos
+    // Hogwild: muestras por hilo entre sincronizaciones. En cada una se
+    // combinan las métricas, avanza el calendario y se publica el snapshot;
+    // entre dos, la tasa y el vecindario no cambian.
+    int syncInterval = 256;
+    BMUStrategy bmuStrategy = BMUStrategy::Exhaustive;
+    ApproxBMUOptions approx;
+    bool logEpochs = true;   // imprime QE y TE al final de cada época
+};
+
+struct StreamOptions {
+    int chunkRows = 4096;     // muestras por bloque leído
+    int prefetchDepth = 4;    // bloques en vuelo en el hilo de E/S
+    bool logEpochs = true;    // imprime QE y TE al final de cada época
+};
+
+struct DistributedOptions {
+    int threads = 0;          // hilos por proceso; 0 = todos los núcleos
+    bool logEpochs = true;    // sólo imprime el coordinador (rango 0)
+};
+
+class Transport;
+
 class Kohonen3D {
 public:
-    Kohonen3D(int sizeX, int sizeY, int sizeZ, int input_dim);
+    // La topología decide qué neuronas son vecinas (ver LatticeTopology.hpp).
+    Kohonen3D(int sizeX, int sizeY, int sizeZ, int input_dim,
+              LatticeTopology topology = LatticeTopology::Rectangular);
+
+    // Decaimiento lineal clásico: TrainingSchedule::linear(lr, radio).
+    void train(const std::vector<Vector>& data, int epochs, float learning_rate_initial, float neighborhood_radius_initial,
+               const TrainOptions& options = TrainOptions());
+    void train(const std::vector<Vector>& data, int epochs, const TrainingSchedule& schedule,
+               const TrainOptions& options = TrainOptions());
+
+    // Entrenamiento online sobre una fuente secuencial: los datos se leen por
+    // bloques en un hilo de fondo y nunca se cargan completos en memoria. Un
+    // calendario por muestra necesita que la fuente conozca su tamaño.
+    void trainStream(SampleSource& source, int epochs, float learning_rate_initial, float neighborhood_radius_initial,
+                     const StreamOptions& options = StreamOptions());
+    void trainStream(SampleSource& source, int epochs, const TrainingSchedule& schedule,
+                     const StreamOptions& options = StreamOptions());
 
-    void train(const std::vector<Vector>& data, int epochs, float learning_rate_initial, float neighborhood_radius_initial);
+    // Batch SOM entre varios procesos (ver Transport.hpp): cada uno llama con
+    // su parte de las muestras y la misma red y calendario. Las sumas de cada
+    // época se combinan con ringAllreduce y todos los procesos terminan con
+    // el mismo codebook; parten del del rango 0, que es el que conviene
+    // guardar con saveCheckpoint. Las métricas son las del conjunto completo.
+    // Si algún proceso tiene otra red, dimensión o número de épocas, todos
+    // lanzan una excepción antes de empezar.
+    void trainDistributed(const std::vector<Vector>& shard, int epochs, float learning_rate_initial,
+                          float neighborhood_radius_initial, Transport& transport,
+                          const DistributedOptions& options = DistributedOptions());
+    void trainDistributed(const std::vector<Vector>& shard, int epochs, const TrainingSchedule& schedule,
+                          Transport& transport, const DistributedOptions& options = DistributedOptions());
 
-    const std::vector<Vector>& getWeights() const;
+    // Continúan el último entrenamiento desde la época guardada, con la tasa
+    // de aprendizaje y el radio ya decaídos que corresponden a esa época.
+    void resume(const std::vector<Vector>& data, const TrainOptions& options = TrainOptions());
+    void resumeStream(SampleSource& source, const StreamOptions& options = StreamOptions());
+
+    // Sustituye las curvas de decaimiento sin tocar el progreso. El checkpoint
+    // sólo guarda el calendario lineal clásico; para reanudar uno
+    // personalizado hay que volver a darlo aquí antes de resume().
+    void setSchedule(const TrainingSchedule& schedule);
+    const TrainingSchedule& getSchedule() const;
+
+    // Checkpoint binario versionado (ver Checkpoint.hpp). La carga proyecta el
+    // fichero con mmap y usa los pesos en sitio; si luego se sigue
+    // entrenando, las páginas modificadas son copy-on-write.
+    void saveCheckpoint(const std::string& filename) const;
+    static Kohonen3D loadCheckpoint(const std::string& filename);
+
+    // Red sobre un codebook ya construido (fila i = neurona lattice.index(...)),
+    // p.ej. para hacer crecer una red existente (ver GrowingSom).
+    static Kohonen3D fromCodebook(const LatticeShape& lattice, WeightMatrix weights);
+
+    // BMU, segunda BMU y error de cuantización de cada muestra con el mapa
+    // actual (ver BatchMapper). Para muchas llamadas sobre un mapa congelado
+    // conviene crear un BatchMapper y reutilizar sus normas.
+    std::vector<MappedSample> mapBatch(const std::vector<Vector>& data,
+                                       const MappingOptions& options = MappingOptions()) const;
+    std::vector<MappedSample> mapBatch(const std::vector<Vector>& data, const std::vector<int>& indices,
+                                       const MappingOptions& options = MappingOptions()) const;
+    std::vector<MappedSample> mapBatch(SampleSource& source, const MappingOptions& options = MappingOptions()) const;
+
+    // Publica el codebook en snapshot (ver WeightSnapshot) cada every_samples
+    // muestras y al final de cada época, para visualizar el entrenamiento
+    // desde otro hilo. nullptr lo desactiva.
+    void setSnapshot(WeightSnapshot* snapshot, int every_samples = 250);
+
+    // Recibe error de cuantización, error topográfico y hits por neurona al
+    // final de cada época y, si every_samples > 0, también cada every_samples
+    // muestras. Las métricas salen de la misma búsqueda de BMU del
+    // entrenamiento. nullptr lo desactiva.
+    void setObserver(TrainingObserver* observer, int every_samples = 0);
+    // Cuando *stop pasa a true (desde cualquier hilo), train, trainStream y
+    // resume vuelven tras la muestra en curso; en modo Hogwild tras la ronda
+    // hasta el siguiente punto de sincronización y en Batch al acabar la
+    // época. La época interrumpida no cuenta: getEpoch() sigue en ella y
+    // resume() la repite. nullptr lo desactiva.
+    void setStopFlag(const std::atomic<bool>* stop);
+    // Métricas de la última época (o de la que está en curso).
+    const TrainingMetrics& getMetrics() const;
+
+    const WeightMatrix& getCodebook() const;
+    RowView getWeight(int neuron) const;
+    int getNumNeurons() const;
+    int getInputDim() const;
     int getSizeX() const;
     int getSizeY() const;
     int getSizeZ() const;
+    LatticeTopology getTopology() const;
+    const LatticeShape& getLattice() const;
+    int getEpoch() const;
+    int getTotalEpochs() const;
 
 private:
-    float euclideanDistanceVec(const Vector& a, const Vector& b);
-    float euclideanDistance3D(int x1, int y1, int z1, int x2, int y2, int z2);
+    Kohonen3D(const LatticeShape& lattice, int input_dim, WeightMatrix weights);
 
-    int sizeX_, sizeY_, sizeZ_;
+    void resetSchedule(int epochs, const TrainingSchedule& schedule);
+    void beginEpoch(long long samples_per_epoch);
+    void enterStep(int step);
+    void runEpochs(const std::vector<Vector>& data, const TrainOptions& options);
+    void runStreamEpochs(SampleSource& source, const StreamOptions& options);
+    // Instanciadas por política de topología (ver withTopology).
+    template <typename Topology>
+    void trainOnline(const std::vector<Vector>& data, const ApproxBMUSearch* approx);
+    // Devuelve la pista para la búsqueda aproximada de la muestra siguiente:
+    // la ganadora o, si se pasa next, la vecina recién actualizada más
+    // cercana a ella (calculada en la misma pasada que la actualización).
+    template <typename Topology>
+    int trainSample(const float* x_in, const ApproxBMUSearch* approx = nullptr, int hint = -1,
+                    const float* next = nullptr);
+    template <typename Topology>
+    void trainHogwildEpoch(const std::vector<Vector>& data, int threads, int sync_interval);
+    template <typename Topology>
+    void trainBatchEpoch(const std::vector<Vector>& data, int threads, const ApproxBMUSearch* approx);
+    template <typename Topology>
+    void accumulateVoronoi(const std::vector<Vector>& data, int threads, const ApproxBMUSearch* approx,
+                           WeightMatrix& sums, std::vector<float>& hits);
+    template <typename Topology>
+    void smoothCodebook(const WeightMatrix& sums, const std::vector<float>& hits, int threads);
+    BMUResult findWinner(const float* x_in, const ApproxBMUSearch* approx, int hint) const;
+    template <typename Topology>
+    void recordMetrics(const BMUResult& winner);
+    void finishEpoch(bool log = true);
+    void publishSnapshot();
+    bool stopRequested() const { return stop_ && stop_->load(std::memory_order_relaxed); }
+
+    LatticeShape lattice_;
     int input_dim_;
-    std::vector<Vector> weights_;
+    WeightMatrix weights_;
+    BMUSearch bmu_;
+    UpdateKernel update_;
+
+    // estado del calendario de entrenamiento
+    int epoch_ = 0;
+    int total_epochs_ = 0;
+    TrainingSchedule schedule_;
+    bool schedule_known_ = true;   // false tras cargar un checkpoint con calendario propio
+    ScheduleTable table_;
+    int step_ = 0;
+    float lr_ = 0.0f;
+    const NeighborhoodStencil* stencil_ = nullptr;
+    long long sample_ = 0;         // muestra global (época * muestras + índice)
+    long long next_step_at_ = 0;
+
+    // vecinas de la BMU en trainSample: primero se recorre el stencil y
+    // después UpdateKernel actualiza todas las filas
+    std::vector<NeighborUpdate> updates_;
+
+    WeightSnapshot* snapshot_ = nullptr;
+    int snapshot_interval_ = 0;
+    int samples_since_snapshot_ = 0;
+
+    TrainingMetrics metrics_;
+    TrainingObserver* observer_ = nullptr;
+    int progress_interval_ = 0;
+
+    const std::atomic<bool>* stop_ = nullptr;
 };
@@ -1,6 +1,11 @@
 #pragma once
 
 #include "KohonenNetwork.hpp"
+#include "LatticeGrid.hpp"
+#include "PrototypeImage.hpp"
+#include "TextureAtlas.hpp"
+#include <chrono>
+#include <memory>
 #include <vector>
 #include <GL/glut.h>
 
@@ -9,7 +14,23 @@ public:
     KohonenVisualizer(Kohonen3D* net);
 
     void initGL();
+    // Forma de las muestras con que se entrena la red; decide cómo se dibuja
+    // cada prototipo (ver makePrototypeRenderer). Si no se da, se deduce de
+    // la dimensión de entrada. Hay que llamarlo antes de initNeurons.
+    void setSampleShape(const SampleShape& shape);
     void initNeurons();
+
+    // Observa un entrenamiento en curso: updateFromSnapshot() sube al atlas
+    // sólo los prototipos que han cambiado desde la última llamada y
+    // devuelve true si hay que redibujar. Se llama desde el hilo de GLUT.
+    // Las barras y el color PCA escalan cada prototipo con el codebook con
+    // que se crearon, así que updateFromSnapshot() los reajusta cada pocos
+    // segundos a la instantánea en curso y redibuja todo el atlas.
+    // refitPrototypes() hace lo mismo con el codebook de la red; hay que
+    // llamarlo al terminar el entrenamiento.
+    void setSnapshotSource(WeightSnapshot* source);
+    bool updateFromSnapshot();
+    void refitPrototypes();
     void renderScene();
     void reshape(int w, int h);
     void onMouse(int btn, int state, int x, int y);
@@ -19,15 +40,63 @@ public:
 private:
     struct Neuron {
         float x, y, z;
+    };
+
+    // Vértice de los quads: posición + coordenadas en el atlas (GL_T2F_V3F).
+    struct Vertex {
+        float u, v;
+        float x, y, z;
+    };
+
+    // Vértice del LOD lejano: color medio del prototipo (GL_C4UB_V3F).
+    struct PointVertex {
+        unsigned char r, g, b, a;
+        float x, y, z;
+    };
+
+    // Una textura por página del atlas y el rango de posiciones que cubre.
+    struct AtlasPage {
         GLuint textureID;
+        int begin, end;
+    };
+
+    // Rango contiguo de posiciones (orden de LatticeGrid) a dibujar.
+    struct DrawRange {
+        int first, count;
     };
 
-    GLuint createTextureFromMNIST(const std::vector<float>& image, int width, int height);
-    void drawTexturedQuad(float x, float y, float z, GLuint textureID);
+    void buildAtlas();
+    void buildVertexBuffers();
+    void setPrototype(int position, RowView prototype);
+    void refitRenderer(const WeightMatrix& codebook);
+    void applyProjection();
+    void collectVisibleCells();
+
+    SampleShape sampleShape;
+    std::unique_ptr<PrototypeRenderer> prototypeRenderer;
+
+    std::vector<Neuron> neurons;        // posiciones centradas en el origen
+    LatticeGrid grid;
+    std::vector<float> cellBounds;      // caja (lo[3], hi[3]) de cada bloque de grid
+    TextureAtlas atlas;                 // tesela i = posición i de grid.order()
+    std::vector<AtlasPage> pages;
+    std::vector<PointVertex> points;
+    GLuint vertexBuffer = 0;
+    GLuint pointBuffer = 0;
+
+    // rangos visibles del fotograma actual (se reutilizan entre fotogramas)
+    std::vector<DrawRange> nearRanges, farRanges;
+    std::vector<GLint> drawFirst;
+    std::vector<GLsizei> drawCount;
+
+    WeightSnapshot* snapshot = nullptr;
+    std::vector<int> changedNeurons;
+    std::chrono::steady_clock::time_point lastRefit;
+    std::vector<unsigned char> tilePixels;
 
-    std::vector<Neuron> neurons;
     Kohonen3D* kohonenNet;
 
+    int viewportWidth = 1, viewportHeight = 1;
     float zoom = -15.0f, angleX = 20.0f, angleY = -30.0f;
     int lastX = 0, lastY = 0;
     bool mouseDown = false;
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+// Bloque de cellSide^3 neuronas vecinas de la red.
+struct GridCell {
+    int first;            // primera posición en order()
+    int count;
+    int lo[3], hi[3];     // rango de índices x, y, z (inclusive)
+};
+
+// Rejilla espacial sobre la red para descartar bloques enteros de neuronas
+// (culling) sin recorrerlas una a una. order() enumera las neuronas bloque a
+// bloque, de modo que cada bloque ocupa un rango contiguo; el visualizador
+// usa ese orden para sus buffers y su atlas.
+class LatticeGrid {
+public:
+    LatticeGrid() = default;
+    LatticeGrid(int sizeX, int sizeY, int sizeZ, int cellSide);
+
+    const std::vector<GridCell>& cells() const { return cells_; }
+    const std::vector<int>& order() const { return order_; }   // posición -> neurona
+    int position(int neuron) const { return position_[neuron]; }
+
+private:
+    std::vector<GridCell> cells_;
+    std::vector<int> order_;
+    std::vector<int> position_;
+};
+
+// Pirámide de visión extraída de proyección * modelview (convención de
+// OpenGL, matrices column-major como las devuelve glGetFloatv).
+class Frustum {
+public:
+    Frustum(const float* projection, const float* modelview);
+
+    // false sólo si la caja queda entera fuera de algún plano.
+    bool intersectsBox(const float* lo, const float* hi) const;
+
+private:
+    float planes_[6][4];
+};
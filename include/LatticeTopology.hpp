@@ -0,0 +1,222 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+// Geometría de la red. El valor numérico se guarda en la cabecera del
+// checkpoint, así que no se deben reordenar.
+enum class LatticeTopology : uint32_t {
+    Rectangular = 0,   // rejilla cúbica acotada
+    Toroidal = 1,      // rejilla cúbica periódica en x, y, z (sin bordes)
+    BodyCentered = 2   // cúbica centrada en el cuerpo: las capas z impares
+                       // van desplazadas medio paso en x e y
+};
+
+// "rect", "torus" o "bcc".
+const char* topologyName(LatticeTopology topology);
+LatticeTopology parseTopology(const std::string& name);
+
+// Dimensiones y topología de una red. El índice de una neurona es siempre
+// (x * sizeY + y) * sizeZ + z; lo que cambia con la topología es qué
+// neuronas son vecinas y a qué distancia están.
+struct LatticeShape {
+    int sizeX = 1, sizeY = 1, sizeZ = 1;
+    LatticeTopology topology = LatticeTopology::Rectangular;
+
+    int neurons() const { return sizeX * sizeY * sizeZ; }
+    int index(int x, int y, int z) const { return (x * sizeY + y) * sizeZ + z; }
+    void decode(int i, int& x, int& y, int& z) const {
+        x = i / (sizeY * sizeZ);
+        y = (i / sizeZ) % sizeY;
+        z = i % sizeZ;
+    }
+
+    // Posición geométrica de la neurona, con vecinas más próximas a
+    // distancia 1 en todas las topologías (para dibujar la red).
+    void position(int i, float out[3]) const;
+    // Vecinas inmediatas: 26-vecindad en las rejillas cúbicas (con vuelta en
+    // la toroidal) y las 14 caras de la celda de Voronoi en la BCC.
+    bool adjacent(int a, int b) const;
+    template <typename Fn>
+    void forEachAdjacent(int i, Fn fn) const;
+
+    bool operator==(const LatticeShape& o) const {
+        return sizeX == o.sizeX && sizeY == o.sizeY && sizeZ == o.sizeZ && topology == o.topology;
+    }
+    bool operator!=(const LatticeShape& o) const { return !(*this == o); }
+};
+
+// Políticas de topología. El bucle de entrenamiento se instancia una vez por
+// política (ver withTopology), de modo que la vuelta de los índices o el
+// stencil que toca según la paridad de la capa se resuelven al compilar y no
+// hay ramas por topología dentro de la actualización.
+//
+//   kWraps        los índices dan la vuelta en los bordes
+//   kVariants     stencils distintos según variant(z) de la ganadora
+//   offset2()     distancia^2 de la ganadora a la neurona (dx, dy, dz)
+//   reach()       desplazamiento máximo por eje para un radio dado
+struct RectangularLattice {
+    static constexpr LatticeTopology kTopology = LatticeTopology::Rectangular;
+    static constexpr bool kWraps = false;
+    static constexpr int kVariants = 1;
+
+    static int variant(int) { return 0; }
+    static float offset2(int, int dx, int dy, int dz) { return static_cast<float>(dx * dx + dy * dy + dz * dz); }
+    static void reach(float radius, int out[3]);
+    static void position(int x, int y, int z, float out[3]) {
+        out[0] = static_cast<float>(x);
+        out[1] = static_cast<float>(y);
+        out[2] = static_cast<float>(z);
+    }
+
+    static bool adjacent(const LatticeShape& s, int a, int b) {
+        int ax, ay, az, bx, by, bz;
+        s.decode(a, ax, ay, az);
+        s.decode(b, bx, by, bz);
+        return std::abs(ax - bx) <= 1 && std::abs(ay - by) <= 1 && std::abs(az - bz) <= 1;
+    }
+
+    template <typename Fn>
+    static void forEachAdjacent(const LatticeShape& s, int i, Fn fn) {
+        int x, y, z;
+        s.decode(i, x, y, z);
+        for (int nx = x - 1; nx <= x + 1; nx++) {
+            if (nx < 0 || nx >= s.sizeX) continue;
+            for (int ny = y - 1; ny <= y + 1; ny++) {
+                if (ny < 0 || ny >= s.sizeY) continue;
+                for (int nz = z - 1; nz <= z + 1; nz++) {
+                    if (nz < 0 || nz >= s.sizeZ || (nx == x && ny == y && nz == z)) continue;
+                    fn(s.index(nx, ny, nz));
+                }
+            }
+        }
+    }
+};
+
+struct ToroidalLattice {
+    static constexpr LatticeTopology kTopology = LatticeTopology::Toroidal;
+    static constexpr bool kWraps = true;
+    static constexpr int kVariants = 1;
+
+    static int variant(int) { return 0; }
+    static float offset2(int, int dx, int dy, int dz) { return static_cast<float>(dx * dx + dy * dy + dz * dz); }
+    static void reach(float radius, int out[3]) { RectangularLattice::reach(radius, out); }
+    static void position(int x, int y, int z, float out[3]) { RectangularLattice::position(x, y, z, out); }
+
+    // distancia mínima entre a y b a lo largo de un eje de tamaño size
+    static int wrapDistance(int a, int b, int size) {
+        int d = std::abs(a - b);
+        return d < size - d ? d : size - d;
+    }
+    static int wrap(int v, int size) { return v < 0 ? v + size : (v >= size ? v - size : v); }
+
+    static bool adjacent(const LatticeShape& s, int a, int b) {
+        int ax, ay, az, bx, by, bz;
+        s.decode(a, ax, ay, az);
+        s.decode(b, bx, by, bz);
+        return wrapDistance(ax, bx, s.sizeX) <= 1 && wrapDistance(ay, by, s.sizeY) <= 1 &&
+               wrapDistance(az, bz, s.sizeZ) <= 1;
+    }
+
+    template <typename Fn>
+    static void forEachAdjacent(const LatticeShape& s, int i, Fn fn) {
+        int x, y, z;
+        s.decode(i, x, y, z);
+        // en ejes de tamaño 1 o 2, -1 y +1 dan la misma neurona: se visita una vez
+        int lo[3], hi[3];
+        const int sizes[3] = {s.sizeX, s.sizeY, s.sizeZ};
+        for (int k = 0; k < 3; k++) {
+            lo[k] = sizes[k] >= 3 ? -1 : 0;
+            hi[k] = sizes[k] >= 2 ? 1 : 0;
+        }
+        for (int dx = lo[0]; dx <= hi[0]; dx++) {
+            for (int dy = lo[1]; dy <= hi[1]; dy++) {
+                for (int dz = lo[2]; dz <= hi[2]; dz++) {
+                    if (dx == 0 && dy == 0 && dz == 0) continue;
+                    fn(s.index(wrap(x + dx, s.sizeX), wrap(y + dy, s.sizeY), wrap(z + dz, s.sizeZ)));
+                }
+            }
+        }
+    }
+};
+
+// Capa z en altura z * a/2; las capas impares desplazadas (a/2, a/2). Con
+// a = 2/sqrt(3) las 8 vecinas de las capas z +- 1 quedan a distancia 1 y las
+// 6 siguientes (+-x, +-y en la misma capa y z +- 2) a distancia a.
+struct BodyCenteredLattice {
+    static constexpr LatticeTopology kTopology = LatticeTopology::BodyCentered;
+    static constexpr bool kWraps = false;
+    static constexpr int kVariants = 2;
+    static constexpr float kCell = 1.1547005f;   // a = 2 / sqrt(3)
+
+    static int variant(int z) { return z & 1; }
+    // en capas de paridad distinta a la de la ganadora el desplazamiento x, y
+    // se corre medio paso: +1/2 desde capa par, -1/2 desde capa impar
+    static float offset2(int parity, int dx, int dy, int dz) {
+        float shift = (dz & 1) ? (parity ? -0.5f : 0.5f) : 0.0f;
+        float fx = dx + shift, fy = dy + shift, fz = 0.5f * dz;
+        return kCell * kCell * (fx * fx + fy * fy + fz * fz);
+    }
+    static void reach(float radius, int out[3]);
+    static void position(int x, int y, int z, float out[3]) {
+        float shift = (z & 1) ? 0.5f : 0.0f;
+        out[0] = kCell * (x + shift);
+        out[1] = kCell * (y + shift);
+        out[2] = kCell * 0.5f * z;
+    }
+
+    static bool adjacent(const LatticeShape& s, int a, int b) {
+        int ax, ay, az, bx, by, bz;
+        s.decode(a, ax, ay, az);
+        s.decode(b, bx, by, bz);
+        int dx = bx - ax, dy = by - ay, dz = bz - az;
+        if (dz == 1 || dz == -1) {
+            int side = (az & 1) ? 1 : -1;
+            return (dx == 0 || dx == side) && (dy == 0 || dy == side);
+        }
+        if (dz == 0) return std::abs(dx) + std::abs(dy) == 1;
+        return (dz == 2 || dz == -2) && dx == 0 && dy == 0;
+    }
+
+    template <typename Fn>
+    static void forEachAdjacent(const LatticeShape& s, int i, Fn fn) {
+        int x, y, z;
+        s.decode(i, x, y, z);
+        auto visit = [&](int nx, int ny, int nz) {
+            if (nx >= 0 && nx < s.sizeX && ny >= 0 && ny < s.sizeY && nz >= 0 && nz < s.sizeZ) fn(s.index(nx, ny, nz));
+        };
+        int side = (z & 1) ? 1 : -1;
+        for (int dz : {-1, 1}) {
+            for (int dx : {0, side}) {
+                for (int dy : {0, side}) visit(x + dx, y + dy, z + dz);
+            }
+        }
+        visit(x - 1, y, z);
+        visit(x + 1, y, z);
+        visit(x, y - 1, z);
+        visit(x, y + 1, z);
+        visit(x, y, z - 2);
+        visit(x, y, z + 2);
+    }
+};
+
+// Llama a fn con la política de la topología: el único punto donde se
+// decide en tiempo de ejecución, fuera de los bucles calientes.
+template <typename Fn>
+decltype(auto) withTopology(LatticeTopology topology, Fn&& fn) {
+    switch (topology) {
+        case LatticeTopology::Toroidal:
+            return fn(ToroidalLattice());
+        case LatticeTopology::BodyCentered:
+            return fn(BodyCenteredLattice());
+        case LatticeTopology::Rectangular:
+        default:
+            return fn(RectangularLattice());
+    }
+}
+
+template <typename Fn>
+void LatticeShape::forEachAdjacent(int i, Fn fn) const {
+    withTopology(topology, [&](auto policy) { decltype(policy)::forEachAdjacent(*this, i, fn); });
+}
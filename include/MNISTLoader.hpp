@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -6,5 +7,7 @@ class MNISTDataset {
 public:
     static std::vector<std::vector<float>> loadImages(const std::string& filename, int max_images = -1);
     static std::vector<std::vector<float>> loadLabels(const std::string& filename, int max_labels = -1);
+    // Una etiqueta (0-9) por byte, sin el one-hot de loadLabels.
+    static std::vector<uint8_t> loadLabelIndices(const std::string& filename, int max_labels = -1);
     static void displayImage(const std::vector<float>& image, int rows, int cols);
 };
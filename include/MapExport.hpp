@@ -0,0 +1,28 @@
+#pragma once
+
+#include "KohonenNetwork.hpp"
+#include <string>
+#include <vector>
+
+// Imagen RGB en memoria, fila 0 arriba.
+struct MapImage {
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> rgb;
+};
+
+// Matriz U: distancia euclídea media de cada neurona a sus vecinas en la red
+// (las de LatticeShape::adjacent, también para el error topográfico). Un
+// valor por neurona, en el orden del codebook.
+std::vector<float> computeUMatrix(const Kohonen3D& net);
+
+// Plano de componente: el peso `component` de cada neurona.
+std::vector<float> componentPlane(const Kohonen3D& net, int component);
+
+// Vista 2D de un valor por neurona: los cortes z = 0 .. sizeZ-1 se colocan
+// en rejilla, cada uno con x hacia la derecha e y hacia arriba, y cada
+// neurona ocupa cell_size x cell_size píxeles. Los valores se normalizan a
+// [min, max] y se colorean con una paleta tipo viridis.
+MapImage renderSlices(const std::vector<float>& values, int sizeX, int sizeY, int sizeZ, int cell_size = 8);
+
+void writeMapImage(const std::string& filename, const MapImage& image);
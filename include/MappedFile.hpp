@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Fichero proyectado en memoria con mmap. En modo privado las escrituras son
+// copy-on-write y nunca llegan al disco.
+class MappedFile {
+public:
+    enum class Mode {
+        ReadOnly,
+        Private
+    };
+
+    explicit MappedFile(const std::string& filename, Mode mode = Mode::ReadOnly);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const unsigned char* data() const { return data_; }
+    unsigned char* mutableData() { return data_; }
+    std::size_t size() const { return size_; }
+    const std::string& filename() const { return filename_; }
+
+    // Indica al kernel que el acceso será secuencial (readahead agresivo).
+    void adviseSequential() const;
+
+private:
+    std::string filename_;
+    unsigned char* data_ = nullptr;
+    std::size_t size_ = 0;
+};
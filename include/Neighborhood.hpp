@@ -0,0 +1,72 @@
+#pragma once
+
+#include "LatticeTopology.hpp"
+#include <algorithm>
+#include <vector>
+
+// Tramo del stencil: neuronas (dx, dy, dz0..dz1) relativas a la ganadora,
+// contiguas en memoria porque z es el índice que varía más rápido.
+struct StencilRun {
+    int dx, dy;
+    int dz0, dz1;
+    int first;    // posición del primer peso h de este tramo
+};
+
+// Vecindario gaussiano precalculado para un radio y una topología. Se
+// construye una vez por radio y se aplica sobre la caja acotada alrededor de
+// la ganadora, sin recorrer toda la red ni evaluar exp/sqrt por muestra.
+//
+// La BCC necesita dos juegos de tramos (capa de la ganadora par o impar). La
+// toroidal depende además del tamaño de la red: los desplazamientos se
+// limitan a media red por eje para que cada neurona se visite una sola vez.
+class NeighborhoodStencil {
+public:
+    NeighborhoodStencil() = default;
+    explicit NeighborhoodStencil(float radius, const LatticeShape& lattice = LatticeShape());
+
+    // Recalcula el stencil sólo si cambia el radio o la red.
+    void rebuild(float radius, const LatticeShape& lattice = LatticeShape());
+
+    float radius() const { return radius_; }
+    const LatticeShape& lattice() const { return lattice_; }
+    int reach() const { return reach_; }
+    int size() const { return static_cast<int>(h_.size()); }
+    const std::vector<StencilRun>& runs(int variant = 0) const { return runs_[variant]; }
+    const std::vector<float>& weights() const { return h_; }
+
+    // Llama a fn(indice_neurona, h) para cada vecina de (cx, cy, cz) dentro
+    // de la red sizeX x sizeY x sizeZ. Topology debe ser la política de la
+    // topología con la que se construyó el stencil.
+    template <typename Topology = RectangularLattice, typename Fn>
+    void forEach(int cx, int cy, int cz, int sizeX, int sizeY, int sizeZ, Fn fn) const {
+        for (const auto& run : runs_[Topology::variant(cz)]) {
+            int x = cx + run.dx;
+            int y = cy + run.dy;
+            const float* h = h_.data() + run.first - (cz + run.dz0);
+            int z0 = cz + run.dz0;
+            int z1 = cz + run.dz1;
+            if constexpr (Topology::kWraps) {
+                int base = (Topology::wrap(x, sizeX) * sizeY + Topology::wrap(y, sizeY)) * sizeZ;
+                // el tramo puede salirse por un extremo de z: se parte en tres
+                int z = z0;
+                for (; z < 0; z++) fn(base + z + sizeZ, h[z]);
+                for (int end = std::min(z1, sizeZ - 1); z <= end; z++) fn(base + z, h[z]);
+                for (; z <= z1; z++) fn(base + z - sizeZ, h[z]);
+            } else {
+                if (x < 0 || x >= sizeX || y < 0 || y >= sizeY) continue;
+                int base = (x * sizeY + y) * sizeZ;
+                for (int z = std::max(0, z0), end = std::min(sizeZ - 1, z1); z <= end; z++) fn(base + z, h[z]);
+            }
+        }
+    }
+
+private:
+    template <typename Topology>
+    void build();
+
+    float radius_ = -1.0f;
+    LatticeShape lattice_;
+    int reach_ = 0;
+    std::vector<StencilRun> runs_[2];
+    std::vector<float> h_;
+};
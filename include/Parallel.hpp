@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Número de hilos efectivo: 0 o negativo significa "todos los núcleos".
+inline int resolveThreadCount(int requested) {
+    if (requested > 0) return requested;
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? static_cast<int>(hw) : 1;
+}
+
+// Reparte [begin, end) en bloques contiguos, uno por hilo, y llama a
+// fn(chunk_begin, chunk_end, thread_id). El hilo llamante procesa el primer
+// bloque. El reparto depende sólo de (begin, end, threads).
+template <typename Fn>
+void parallelFor(int begin, int end, int threads, Fn fn) {
+    int total = end - begin;
+    if (total <= 0) return;
+    threads = std::max(1, std::min(threads, total));
+    if (threads == 1) {
+        fn(begin, end, 0);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    int chunk = total / threads;
+    int extra = total % threads;
+    int start = begin;
+    int first_end = 0;
+    for (int t = 0; t < threads; t++) {
+        int stop = start + chunk + (t < extra ? 1 : 0);
+        if (t == 0) {
+            first_end = stop;
+        } else {
+            workers.emplace_back(fn, start, stop, t);
+        }
+        start = stop;
+    }
+    fn(begin, first_end, 0);
+    for (auto& w : workers) w.join();
+}
+
+// Barrera reutilizable para count hilos: wait() bloquea hasta que llegan
+// todos. Lo escrito antes de wait() es visible para todos después.
+class Barrier {
+public:
+    explicit Barrier(int count) : count_(count) {}
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        long long generation = generation_;
+        if (++arrived_ == count_) {
+            arrived_ = 0;
+            generation_++;
+            cv_.notify_all();
+            return;
+        }
+        cv_.wait(lock, [&] { return generation != generation_; });
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    int count_;
+    int arrived_ = 0;
+    long long generation_ = 0;
+};
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <string>
+
+// Escribe una imagen de 8 bits por canal (1 = gris, 3 = RGB, 4 = RGBA) como
+// PNG, con la fila 0 arriba. Lanza std::runtime_error si no puede escribir.
+void writePNG(const std::string& filename, int width, int height, int channels,
+              const unsigned char* pixels);
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "AlignedBuffer.hpp"
+#include "SampleSource.hpp"
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Lee bloques de una SampleSource en un hilo de E/S de fondo sobre un anillo
+// acotado de buffers, de modo que la lectura del siguiente bloque se solapa
+// con el cómputo del actual. La memoria usada es depth * chunk_rows * dim.
+class PrefetchReader {
+public:
+    PrefetchReader(SampleSource& source, int chunk_rows, int depth);
+    ~PrefetchReader();
+
+    PrefetchReader(const PrefetchReader&) = delete;
+    PrefetchReader& operator=(const PrefetchReader&) = delete;
+
+    // Devuelve el siguiente bloque (rows x dim) o nullptr al final de la
+    // pasada. El puntero es válido hasta la siguiente llamada.
+    const float* next(int& rows);
+
+private:
+    struct Slot {
+        AlignedBuffer<float> data;
+        int rows = 0;
+    };
+
+    void produce();
+
+    SampleSource& source_;
+    int chunk_rows_;
+    std::vector<Slot> slots_;
+    int filled_ = 0;        // bloques listos para consumir
+    int head_ = 0;          // siguiente bloque a consumir
+    bool holding_ = false;  // el consumidor retiene el bloque anterior
+    bool done_ = false;
+    bool stop_ = false;
+    std::exception_ptr error_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread worker_;
+};
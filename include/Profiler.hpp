@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+// Instrumentación del entrenamiento. Se activa al compilar con
+// -DKOHONEN_PROFILE=ON en CMake; desactivada, las macros KOHONEN_PROFILE_*
+// no generan código. Cada hilo escribe en sus propios contadores, así que
+// en el camino caliente no hay cerrojos ni escrituras compartidas.
+#ifndef KOHONEN_PROFILE
+#define KOHONEN_PROFILE 0
+#endif
+
+enum class ProfilePhase : uint8_t {
+    Epoch,             // una época completa
+    BMUSearch,
+    Neighborhood,      // evaluación del stencil (vecinas y pesos h)
+    WeightUpdate,      // actualización de los prototipos
+    BatchAccumulate,   // batch: sumas de Voronoi por neurona
+    StreamWait,        // entrenamiento en streaming: espera al lector
+    Count
+};
+
+constexpr int kProfilePhases = static_cast<int>(ProfilePhase::Count);
+
+const char* profilePhaseName(ProfilePhase phase);
+
+// Marca de tiempo barata: TSC en x86, steady_clock en el resto. Profiler
+// calibra la conversión a segundos.
+inline uint64_t profileTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+struct ProfileCounters {
+    uint64_t ticks[kProfilePhases] = {};
+    uint64_t calls[kProfilePhases] = {};
+    uint64_t samples = 0;
+    uint64_t neuronsTouched = 0;   // neuronas actualizadas
+    uint64_t bytesMoved = 0;       // bytes de codebook leídos y escritos
+};
+
+struct TraceEvent {
+    ProfilePhase phase;
+    uint64_t start, end;
+};
+
+// Datos de un hilo. Al terminar el hilo quedan libres para el siguiente
+// (parallelFor crea hilos en cada llamada), conservando lo acumulado.
+struct ThreadProfile {
+    int slot = 0;
+    ProfileCounters counters;
+    std::vector<TraceEvent> events;   // sólo tramos largos (épocas, fases batch)
+};
+
+struct ProfileReport {
+    double seconds[kProfilePhases] = {};
+    uint64_t calls[kProfilePhases] = {};
+    uint64_t samples = 0;
+    uint64_t neuronsTouched = 0;
+    uint64_t bytesMoved = 0;
+
+    double samplesPerSecond() const;
+    double neuronsPerSample() const;
+    // Tabla legible: tiempo y porcentaje por fase y totales.
+    void print(std::ostream& out) const;
+};
+
+class Profiler {
+public:
+    static Profiler& instance();
+
+    // Contadores del hilo actual; la primera llamada de cada hilo lo
+    // registra (con cerrojo), las siguientes sólo leen un thread_local.
+    static ThreadProfile& local();
+
+    // Sólo entre entrenamientos: no es seguro con hilos escribiendo.
+    void reset();
+    ProfileReport report() const;
+    // Formato "Trace Event" de Chrome (chrome://tracing, Perfetto): un evento
+    // "X" por tramo, con un tid por hilo.
+    void writeChromeTrace(const std::string& filename) const;
+
+private:
+    friend struct ThreadProfileHandle;
+
+    Profiler();
+    ThreadProfile* acquire();
+    void release(ThreadProfile* profile);
+    double secondsPerTick() const;
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadProfile>> profiles_;
+    std::vector<ThreadProfile*> free_;
+    uint64_t origin_ticks_;
+    double origin_seconds_;
+};
+
+// Acumula el tiempo del ámbito en la fase; con Trace también lo guarda como
+// evento para la traza (sólo para tramos largos, no por muestra).
+template <bool Trace>
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfilePhase phase) : profile_(Profiler::local()), phase_(phase), start_(profileTicks()) {}
+    ~ProfileScope() {
+        uint64_t end = profileTicks();
+        int p = static_cast<int>(phase_);
+        profile_.counters.ticks[p] += end - start_;
+        profile_.counters.calls[p]++;
+        if (Trace) profile_.events.push_back({phase_, start_, end});
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ThreadProfile& profile_;
+    ProfilePhase phase_;
+    uint64_t start_;
+};
+
+#define KOHONEN_PROFILE_CONCAT2(a, b) a##b
+#define KOHONEN_PROFILE_CONCAT(a, b) KOHONEN_PROFILE_CONCAT2(a, b)
+
+#if KOHONEN_PROFILE
+// Tiempo por fase (ámbitos cortos, p.ej. por muestra).
+#define KOHONEN_PROFILE_SCOPE(phase) \
+    ProfileScope<false> KOHONEN_PROFILE_CONCAT(profile_scope_, __LINE__)(ProfilePhase::phase)
+// Tiempo por fase y evento en la traza.
+#define KOHONEN_PROFILE_SPAN(phase) \
+    ProfileScope<true> KOHONEN_PROFILE_CONCAT(profile_span_, __LINE__)(ProfilePhase::phase)
+#define KOHONEN_PROFILE_COUNT(samples_, neurons_, bytes_)              \
+    do {                                                               \
+        ProfileCounters& profile_counters_ = Profiler::local().counters; \
+        profile_counters_.samples += (samples_);                       \
+        profile_counters_.neuronsTouched += (neurons_);                \
+        profile_counters_.bytesMoved += (bytes_);                      \
+    } while (0)
+#else
+#define KOHONEN_PROFILE_SCOPE(phase) ((void)0)
+#define KOHONEN_PROFILE_SPAN(phase) ((void)0)
+#define KOHONEN_PROFILE_COUNT(samples_, neurons_, bytes_) ((void)sizeof((samples_), (neurons_), (bytes_)))
+#endif
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "SampleShape.hpp"
+#include "WeightMatrix.hpp"
+#include <memory>
+#include <vector>
+
+// Conversión de un prototipo (pesos en [0, 1]) a píxeles RGB en escala de
+// grises. No depende de OpenGL, de modo que se puede usar sin ventana.
+void prototypeToRGB(RowView prototype, int width, int height, unsigned char* out);
+
+// Dibuja un prototipo como una tesela RGB de width() x height() píxeles
+// (fila 0 primero, como la espera glTexImage2D). Tampoco depende de OpenGL.
+class PrototypeRenderer {
+public:
+    virtual ~PrototypeRenderer() = default;
+
+    virtual int width() const = 0;
+    virtual int height() const = 0;
+    virtual void render(RowView prototype, unsigned char* rgb) const = 0;
+};
+
+// El prototipo es una imagen en gris o RGB (intercalado) con valores en [0, 1].
+class ImageTileRenderer : public PrototypeRenderer {
+public:
+    ImageTileRenderer(int width, int height, int channels = 1);
+
+    int width() const override { return width_; }
+    int height() const override { return height_; }
+    void render(RowView prototype, unsigned char* rgb) const override;
+
+private:
+    int width_, height_, channels_;
+};
+
+// Diagrama de barras, una por componente, para vectores cortos. Cada
+// componente se escala con su rango [mín, máx] en el codebook de referencia.
+class BarGlyphRenderer : public PrototypeRenderer {
+public:
+    explicit BarGlyphRenderer(const WeightMatrix& codebook);
+
+    int width() const override { return width_; }
+    int height() const override { return kHeight; }
+    void render(RowView prototype, unsigned char* rgb) const override;
+
+private:
+    static constexpr int kHeight = 32;
+
+    int width_;
+    std::vector<float> lo_, scale_;
+};
+
+// Vectores de cualquier dimensión (p.ej. embeddings): cada prototipo se
+// proyecta sobre las tres componentes principales del codebook de
+// referencia y se pinta como un color liso. La base se calcula una vez; con
+// un codebook que cambia mucho (entrenamiento en vivo) conviene recrearlo.
+class PcaColorRenderer : public PrototypeRenderer {
+public:
+    explicit PcaColorRenderer(const WeightMatrix& codebook);
+
+    int width() const override { return kTileSize; }
+    int height() const override { return kTileSize; }
+    void render(RowView prototype, unsigned char* rgb) const override;
+
+private:
+    static constexpr int kTileSize = 8;
+
+    std::vector<float> mean_;
+    std::vector<float> axes_[3];
+    float lo_[3], scale_[3];
+};
+
+// Elige el renderizador según la forma: imagen -> tesela, vector de hasta
+// 64 componentes -> barras, resto -> color PCA.
+std::unique_ptr<PrototypeRenderer> makePrototypeRenderer(const SampleShape& shape, const WeightMatrix& codebook);
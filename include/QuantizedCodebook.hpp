@@ -0,0 +1,64 @@
+#pragma once
+
+#include "KohonenNetwork.hpp"
+#include "AlignedBuffer.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+enum class QuantFormat {
+    Int8,      // pesos en [0, 127] (7 bits) para el producto u8 x s8, ver QuantizedCodebook
+    Float16
+};
+
+struct QuantizationReport {
+    int samples = 0;
+    float bmuAgreement = 0.0f;          // fracción de muestras con la misma BMU que fp32
+    float quantErrorFp32 = 0.0f;        // error de cuantización medio con la BMU exacta
+    float quantErrorQuantized = 0.0f;   // mismo error usando la BMU del codebook cuantizado
+    std::size_t bytesFp32 = 0;
+    std::size_t bytesQuantized = 0;
+
+    void print(std::ostream& out) const;
+};
+
+// Representación congelada de un Kohonen3D entrenado, sólo para inferencia.
+// Int8 reduce el codebook 4x y busca la BMU con productos enteros
+// (AVX512-VNNI vpdpbusd o AVX2 vpmaddwd); Float16 lo reduce 2x y convierte
+// con F16C dentro del kernel.
+//
+// Int8 lleva pesos y entradas a [0, 1] con una transformación afín común,
+// (v - mínimo) / (máximo - mínimo) sobre todos los pesos del codebook: al ser
+// la misma para todas las dimensiones no cambia el orden de las distancias.
+// Las componentes de la entrada fuera de ese rango se saturan a sus
+// extremos.
+class QuantizedCodebook {
+public:
+    QuantizedCodebook(const Kohonen3D& net, QuantFormat format);
+
+    // Entrada en bytes crudos (p.ej. píxeles MNIST 0..255).
+    int find(const uint8_t* input) const;
+    // Entrada en [0, 1], como la usada en el entrenamiento.
+    int find(const float* input) const;
+
+    QuantizationReport compare(const Kohonen3D& net, const std::vector<Vector>& samples) const;
+
+    QuantFormat format() const { return format_; }
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+    std::size_t sizeBytes() const;
+
+private:
+    uint8_t quantizeInput(float v) const;
+
+    QuantFormat format_;
+    int rows_, cols_;
+    int stride_;                         // elementos por fila, múltiplo de 64 bytes
+    float offset_ = 0.0f;                // Int8: mínimo de los pesos
+    float invRange_ = 1.0f;              // Int8: 1 / (máximo - mínimo)
+    uint8_t byteTable_[256] = {};        // Int8: byte de entrada -> entrada cuantizada
+    AlignedBuffer<int8_t> int8Weights_;
+    AlignedBuffer<int64_t> normTerms_;   // 255 * ||w_q||^2 por neurona
+    AlignedBuffer<uint16_t> halfWeights_;
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Forma de una muestra: {dim} para vectores, {alto, ancho} o {alto, ancho,
+// canales} para imágenes. El producto de dims es la dimensión de entrada.
+struct SampleShape {
+    std::vector<int> dims;
+
+    bool empty() const { return dims.empty(); }
+    int size() const;
+    // Imagen en gris ({h, w} o {h, w, 1}) o en color ({h, w, 3}).
+    bool isImage() const;
+    int width() const { return dims.size() >= 2 ? dims[1] : size(); }
+    int height() const { return dims.size() >= 2 ? dims[0] : 1; }
+    int channels() const { return dims.size() == 3 ? dims[2] : 1; }
+    std::string toString() const;
+
+    static SampleShape vector(int dim) { return SampleShape{{dim}}; }
+    // "512", "28x28", "32x32x3"
+    static SampleShape parse(const std::string& text);
+    // Sin metadatos (p.ej. un checkpoint) sólo se reconoce el caso de MNIST,
+    // 784 = 28x28; el resto se trata como vector.
+    static SampleShape guess(int dim);
+};
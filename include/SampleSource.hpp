@@ -0,0 +1,157 @@
+#pragma once
+
+#include "IdxDataset.hpp"
+#include "MappedFile.hpp"
+#include "SampleShape.hpp"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Fuente secuencial de muestras float de dimensión fija. Permite entrenar
+// sobre datos que no caben en memoria: sólo se materializa un bloque a la vez.
+class SampleSource {
+public:
+    virtual ~SampleSource() = default;
+
+    virtual int dim() const = 0;
+    // Copia hasta max_rows muestras consecutivas en out (max_rows x dim()).
+    // Devuelve el número de filas leídas; 0 indica fin de la pasada.
+    virtual int read(float* out, int max_rows) = 0;
+    // Vuelve al inicio para una nueva época.
+    virtual void rewind() = 0;
+    // Número de muestras por pasada, o -1 si no se conoce.
+    virtual long long sizeHint() const { return -1; }
+    // Forma de cada muestra (por defecto, un vector de dim() componentes).
+    virtual SampleShape shape() const { return SampleShape::vector(dim()); }
+};
+
+// Muestras de un fichero IDX proyectado en memoria, normalizadas con scale.
+class IdxSampleSource : public SampleSource {
+public:
+    explicit IdxSampleSource(const std::string& filename, float scale = 1.0f / 255.0f, int max_samples = -1);
+
+    int dim() const override { return dataset_.sampleSize(); }
+    int read(float* out, int max_rows) override;
+    void rewind() override { cursor_ = 0; }
+    long long sizeHint() const override { return count_; }
+    SampleShape shape() const override;
+
+private:
+    IdxDataset dataset_;
+    float scale_;
+    int count_;
+    int cursor_ = 0;
+};
+
+// Muestras producidas por una función; generator(out) rellena una muestra
+// y devuelve false cuando no hay más. Cada pasada entrega como mucho
+// samples_per_epoch muestras (-1 = hasta que el generador se agote).
+class GeneratorSampleSource : public SampleSource {
+public:
+    using Generator = std::function<bool(float*)>;
+
+    GeneratorSampleSource(int dim, Generator generator, long long samples_per_epoch = -1);
+
+    int dim() const override { return dim_; }
+    int read(float* out, int max_rows) override;
+    void rewind() override { produced_ = 0; exhausted_ = false; }
+    long long sizeHint() const override { return samples_per_epoch_; }
+
+private:
+    int dim_;
+    Generator generator_;
+    long long samples_per_epoch_;
+    long long produced_ = 0;
+    bool exhausted_ = false;
+};
+
+// Subconjunto de un conjunto de datos en memoria: entrega samples[indices[k]]
+// en el orden de indices sin copiar el conjunto. Ambos vectores deben vivir
+// mientras se use la fuente.
+class SubsetSampleSource : public SampleSource {
+public:
+    SubsetSampleSource(const std::vector<std::vector<float>>& samples, const std::vector<int>& indices);
+
+    int dim() const override { return dim_; }
+    int read(float* out, int max_rows) override;
+    void rewind() override { cursor_ = 0; }
+    long long sizeHint() const override { return static_cast<long long>(indices_.size()); }
+
+private:
+    const std::vector<std::vector<float>>& samples_;
+    const std::vector<int>& indices_;
+    int dim_;
+    std::size_t cursor_ = 0;
+};
+
+// Filas float32 crudas (orden nativo) leídas de un descriptor: fichero,
+// pipe o socket. rewind() sólo funciona si el descriptor admite lseek.
+class RawStreamSampleSource : public SampleSource {
+public:
+    RawStreamSampleSource(int fd, int dim);
+
+    int dim() const override { return dim_; }
+    int read(float* out, int max_rows) override;
+    void rewind() override;
+
+private:
+    int fd_;
+    int dim_;
+};
+
+// Fichero de float32 crudos (orden nativo, filas contiguas, sin cabecera)
+// proyectado con mmap. La forma no está en el fichero y hay que darla.
+class Float32FileSampleSource : public SampleSource {
+public:
+    Float32FileSampleSource(const std::string& filename, const SampleShape& shape);
+
+    int dim() const override { return shape_.size(); }
+    int read(float* out, int max_rows) override;
+    void rewind() override { cursor_ = 0; }
+    long long sizeHint() const override { return count_; }
+    SampleShape shape() const override { return shape_; }
+
+private:
+    MappedFile file_;
+    SampleShape shape_;
+    long long count_;
+    long long cursor_ = 0;
+};
+
+// CSV de números (una muestra por línea) proyectado con mmap y convertido
+// directamente al bloque de salida con std::from_chars, sin copias ni
+// reservas por fila. La dimensión se toma de la primera fila de datos; si la
+// primera línea no es numérica se trata como cabecera. shape, si se da, debe
+// tener esa misma dimensión.
+class CsvSampleSource : public SampleSource {
+public:
+    explicit CsvSampleSource(const std::string& filename, char delimiter = ',',
+                             const SampleShape& shape = SampleShape());
+
+    int dim() const override { return dim_; }
+    int read(float* out, int max_rows) override;
+    void rewind() override;
+    SampleShape shape() const override { return shape_; }
+
+private:
+    // Parsea la línea que empieza en p; devuelve el número de campos y deja
+    // p al inicio de la siguiente. out puede ser nullptr (sólo contar).
+    int parseLine(const char*& p, float* out, int max_fields) const;
+
+    MappedFile file_;
+    char delimiter_;
+    int dim_ = 0;
+    SampleShape shape_;
+    const char* begin_;       // primera fila de datos
+    const char* end_;
+    const char* cursor_;
+    long long line_ = 1;      // para los mensajes de error
+    long long first_line_ = 1;
+};
+
+// Abre un fichero de muestras según su extensión: .csv / .tsv como CSV,
+// .f32 / .raw / .bin como float32 crudo (shape obligatoria) y cualquier
+// otro como IDX.
+std::unique_ptr<SampleSource> openSampleSource(const std::string& filename,
+                                               const SampleShape& shape = SampleShape());
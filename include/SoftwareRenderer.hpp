@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CameraPath.hpp"
+#include "KohonenNetwork.hpp"
+#include "PrototypeImage.hpp"
+#include <vector>
+
+// Rasterizador por CPU que dibuja la red igual que KohonenVisualizer (cada
+// neurona como un quad con su prototipo, misma cámara y proyección), sin
+// OpenGL ni ventana. Pensado para generar imágenes en máquinas sin display;
+// no tiene estado global, así que se pueden lanzar varios procesos a la vez.
+class SoftwareRenderer {
+public:
+    SoftwareRenderer(int width, int height);
+
+    // Convierte los prototipos de la red a teselas RGB con prototypes y
+    // guarda la geometría de la red. Hay que volver a llamarlo si cambian
+    // los pesos.
+    void setNetwork(const Kohonen3D& net, const PrototypeRenderer& prototypes);
+
+    // Devuelve width x height píxeles RGB, fila 0 arriba. El búfer es
+    // válido hasta la siguiente llamada.
+    const std::vector<unsigned char>& render(const Camera& camera);
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+private:
+    struct ScreenVertex {
+        float x, y;       // píxeles
+        float invW;       // 1 / profundidad en espacio de cámara
+        float u, v;       // coordenadas de textura
+    };
+
+    void drawTriangle(const ScreenVertex& a, const ScreenVertex& b, const ScreenVertex& c,
+                      const unsigned char* tile);
+    void sample(const unsigned char* tile, float u, float v, unsigned char* out) const;
+
+    int width_, height_;
+    int tile_width_ = 0, tile_height_ = 0;
+    int lattice_size_[3] = {0, 0, 0};    // para el plano lejano
+    std::vector<float> positions_;       // x, y, z de cada neurona, centradas en el origen
+    std::vector<unsigned char> tiles_;   // una tesela RGB por neurona
+    std::vector<unsigned char> color_;
+    std::vector<float> depth_;           // 1/w; 0 = vacío
+};
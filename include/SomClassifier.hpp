@@ -0,0 +1,47 @@
+#pragma once
+
+#include "BatchMapper.hpp"
+#include "KohonenNetwork.hpp"
+#include <cstdint>
+#include <vector>
+
+struct ClassificationReport {
+    int samples = 0;
+    int correct = 0;
+    float accuracy = 0.0f;
+    std::vector<int> confusion;   // classes x classes, fila = etiqueta real
+};
+
+// Clasificador sobre un mapa entrenado: cada neurona recibe el histograma de
+// etiquetas de las muestras de entrenamiento de las que es BMU; su etiqueta
+// es la mayoritaria y su distribución, el histograma normalizado. Predecir
+// es sólo buscar la BMU (BatchMapper) y leer la etiqueta de esa neurona.
+//
+// Trabaja sobre resultados de BatchMapper en lugar de sobre las muestras, de
+// modo que se puede combinar con cualquier fuente de datos y reutilizar un
+// mismo mapeo para varias cosas.
+class SomClassifier {
+public:
+    SomClassifier(const Kohonen3D& net, int classes = 10);
+
+    // Las neuronas que no son BMU de ninguna muestra toman la media de las
+    // distribuciones de sus vecinas inmediatas ya etiquetadas (según la
+    // topología de la red), por capas, hasta cubrir la red.
+    void fit(const std::vector<MappedSample>& mapped, const std::vector<uint8_t>& labels);
+
+    int classes() const { return classes_; }
+    int label(int neuron) const { return labels_[neuron]; }
+    // classes() probabilidades de la neurona.
+    const float* probabilities(int neuron) const { return &probabilities_[static_cast<std::size_t>(neuron) * classes_]; }
+
+    // 255 si la neurona no tiene etiqueta (antes de fit()).
+    uint8_t predict(const MappedSample& sample) const { return static_cast<uint8_t>(labels_[sample.bmu]); }
+    std::vector<uint8_t> predict(const std::vector<MappedSample>& mapped) const;
+    ClassificationReport evaluate(const std::vector<MappedSample>& mapped, const std::vector<uint8_t>& labels) const;
+
+private:
+    LatticeShape lattice_;
+    int classes_;
+    std::vector<int> labels_;           // -1 antes de fit()
+    std::vector<float> probabilities_;  // neuronas x classes
+};
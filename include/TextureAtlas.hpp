@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+
+struct AtlasTile {
+    int page;
+    int x, y;                  // esquina de la tesela (sin margen) en la página
+    float u0, v0, u1, v1;      // coordenadas de textura normalizadas
+};
+
+// Empaqueta teselas RGB del mismo tamaño en una rejilla sobre una o varias
+// páginas de como mucho maxPageSize x maxPageSize píxeles (el límite de
+// GL_MAX_TEXTURE_SIZE). La tesela i ocupa la página i / tilesPerPage(), así
+// que las teselas consecutivas comparten página. No depende de OpenGL.
+//
+// Con padding > 0 cada tesela se rodea de un margen que repite sus bordes,
+// para que el filtrado (y los mipmaps) no mezclen teselas vecinas.
+class TextureAtlas {
+public:
+    TextureAtlas() = default;
+    TextureAtlas(int tileWidth, int tileHeight, int tileCount, int maxPageSize, int padding = 0);
+
+    int tileWidth() const { return tileWidth_; }
+    int tileHeight() const { return tileHeight_; }
+    int tileCount() const { return static_cast<int>(tiles_.size()); }
+    int tilesPerPage() const { return columns_ * rows_; }
+    int pageCount() const { return static_cast<int>(pages_.size()); }
+    int padding() const { return padding_; }
+    int slotWidth() const { return tileWidth_ + 2 * padding_; }     // tesela + margen
+    int slotHeight() const { return tileHeight_ + 2 * padding_; }
+    int pageWidth() const { return columns_ * slotWidth(); }
+    int pageHeight() const { return rows_ * slotHeight(); }
+
+    const AtlasTile& tile(int index) const { return tiles_[index]; }
+    const unsigned char* pageData(int page) const { return pages_[page].data(); }
+
+    // Copia una tesela de tileWidth x tileHeight píxeles RGB en su sitio
+    // (y rellena su margen).
+    void setTile(int index, const unsigned char* rgb);
+
+private:
+    int tileWidth_ = 0;
+    int tileHeight_ = 0;
+    int padding_ = 0;
+    int columns_ = 0;
+    int rows_ = 0;
+    std::vector<AtlasTile> tiles_;
+    std::vector<std::vector<unsigned char>> pages_;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+
+// Métricas de calidad acumuladas durante el entrenamiento con las BMUs que
+// ya calcula el bucle (primera y segunda en la misma pasada), sin recorrer
+// de nuevo los datos. Las distancias son las de cada muestra antes de
+// aplicar su propia actualización (en modo batch, las del codebook de la
+// época anterior).
+class TrainingMetrics {
+public:
+    explicit TrainingMetrics(int neurons = 0);
+
+    void reset();
+
+    // distance: distancia al cuadrado a la BMU. second_known es falso si la
+    // búsqueda no dio segunda BMU (búsqueda aproximada).
+    void add(int bmu, float distance, bool second_known, bool second_adjacent);
+    // Suma lo acumulado por other (p.ej. por otro hilo) sobre la misma red.
+    void merge(const TrainingMetrics& other);
+    // Contadores como vector de doubles: sumar elemento a elemento los de
+    // varias métricas equivale a merge() (para combinarlas entre procesos).
+    std::vector<double> pack() const;
+    void unpack(const std::vector<double>& packed);
+
+    long long samples() const { return samples_; }
+    // Media de ||x - w_bmu||.
+    double quantizationError() const;
+    // Fracción de muestras cuya segunda BMU no es vecina de la primera en la
+    // red; -1 si ninguna muestra tenía segunda BMU.
+    double topographicError() const;
+    // Muestras asignadas a cada neurona.
+    const std::vector<int>& hits() const { return hits_; }
+    // Neuronas sin ninguna muestra.
+    int deadNeurons() const;
+
+private:
+    long long samples_ = 0;
+    double error_sum_ = 0.0;
+    long long topo_samples_ = 0;
+    long long topo_errors_ = 0;
+    std::vector<int> hits_;
+};
+
+// Recibe las métricas de Kohonen3D (ver setObserver). Se llama desde el hilo
+// que entrena; metrics sólo es válido durante la llamada.
+class TrainingObserver {
+public:
+    virtual ~TrainingObserver() = default;
+
+    // Cada N muestras, con lo acumulado desde el inicio de la época.
+    virtual void onProgress(int /*epoch*/, const TrainingMetrics& /*metrics*/) {}
+    virtual void onEpochEnd(int /*epoch*/, const TrainingMetrics& /*metrics*/) {}
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Neighborhood.hpp"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Curva de decaimiento v(t), con t el progreso del entrenamiento en [0, 1].
+class Decay {
+public:
+    enum class Kind : uint8_t {
+        Linear,
+        Exponential,
+        InverseTime,
+        Piecewise
+    };
+
+    // initial -> final en línea recta; final = 0 es el decaimiento clásico.
+    static Decay linear(float initial, float final_value = 0.0f);
+    // initial * (final / initial)^t; final debe ser > 0.
+    static Decay exponential(float initial, float final_value);
+    // initial / (1 + rate * t).
+    static Decay inverseTime(float initial, float rate);
+    // Interpolación lineal entre puntos (t, valor) con t creciente; fuera
+    // del rango se mantiene el valor del extremo.
+    static Decay piecewise(std::vector<std::pair<float, float>> points);
+
+    float at(float t) const;
+    float initial() const { return at(0.0f); }
+    Kind kind() const { return kind_; }
+    bool isLinearToZero() const { return kind_ == Kind::Linear && b_ == 0.0f; }
+
+private:
+    Kind kind_ = Kind::Linear;
+    float a_ = 0.0f, b_ = 0.0f;
+    std::vector<std::pair<float, float>> points_;
+};
+
+enum class ScheduleGranularity {
+    Epoch,    // un valor por época (t = época / épocas)
+    Sample    // el valor avanza dentro de la época, muestra a muestra
+};
+
+struct TrainingSchedule {
+    Decay learningRate = Decay::linear(0.1f);
+    Decay radius = Decay::linear(3.0f);
+    ScheduleGranularity granularity = ScheduleGranularity::Epoch;
+
+    // lr * (1 - época / épocas), el calendario original.
+    static TrainingSchedule linear(float learning_rate, float radius);
+
+    // El único calendario que la cabecera del checkpoint describe entero.
+    bool isClassicLinear() const {
+        return granularity == ScheduleGranularity::Epoch && learningRate.isLinearToZero() && radius.isLinearToZero();
+    }
+};
+
+// Calendario precalculado para un entrenamiento concreto: tasa de
+// aprendizaje y stencil de vecindario por paso, de modo que el bucle de
+// entrenamiento sólo lee tablas (sin exp ni pow por muestra).
+//
+// Por época hay un paso por época. Por muestra, el entrenamiento completo
+// (épocas x muestras) se divide en hasta kMaxSampleSteps pasos iguales y el
+// radio se redondea a kRadiusQuantum; los stencils de radios repetidos se
+// comparten, así que su número queda acotado por radio inicial / cuanto.
+class ScheduleTable {
+public:
+    static constexpr int kMaxSampleSteps = 8192;
+    static constexpr float kRadiusQuantum = 1.0f / 16.0f;
+
+    ScheduleTable() = default;
+    ScheduleTable(const TrainingSchedule& schedule, int epochs, long long samples_per_epoch,
+                  const LatticeShape& lattice = LatticeShape());
+
+    bool matches(int epochs, long long samples_per_epoch, const LatticeShape& lattice) const {
+        return epochs == epochs_ && samples_per_epoch == samples_per_epoch_ && lattice == lattice_ && steps_ > 0;
+    }
+    int steps() const { return steps_; }
+    // Paso que contiene la muestra global (época * muestras + índice).
+    int stepForSample(long long sample) const;
+    // Primera muestra global del paso.
+    long long stepStart(int step) const;
+    int stepForEpoch(int epoch) const;
+
+    float learningRate(int step) const { return learning_rate_[step]; }
+    const NeighborhoodStencil& stencil(int step) const { return stencils_[stencil_of_[step]]; }
+    int stencilCount() const { return static_cast<int>(stencils_.size()); }
+
+private:
+    bool per_sample_ = false;
+    int epochs_ = 0;
+    long long samples_per_epoch_ = 0;
+    LatticeShape lattice_;
+    long long total_samples_ = 0;
+    int steps_ = 0;
+    std::vector<float> learning_rate_;
+    std::vector<int> stencil_of_;
+    std::vector<NeighborhoodStencil> stencils_;
+};
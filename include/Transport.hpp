@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Canal entre los procesos de un entrenamiento distribuido (ver
+// Kohonen3D::trainDistributed). Cada proceso tiene un rango en [0, size());
+// el 0 hace de coordinador. Las operaciones son bloqueantes y los mensajes
+// entre dos procesos llegan en orden.
+class Transport {
+public:
+    virtual ~Transport() = default;
+
+    virtual int rank() const = 0;
+    virtual int size() const = 0;
+
+    virtual void send(int peer, const void* data, std::size_t bytes) = 0;
+    virtual void recv(int peer, void* data, std::size_t bytes) = 0;
+    // Envía a to y recibe de from a la vez (to y from pueden coincidir). Con
+    // send() y recv() por separado, un anillo en el que todos envían primero
+    // se bloquearía en cuanto los mensajes no cupieran en los buffers.
+    virtual void sendRecv(int to, const void* send_data, std::size_t send_bytes,
+                          int from, void* recv_data, std::size_t recv_bytes) = 0;
+};
+
+// Sockets Unix entre procesos de la misma máquina. El proceso de rango r
+// escucha en "<prefix>.<r>", se conecta a los de rango menor y acepta a los
+// de rango mayor, así que todos pueden arrancar en cualquier orden (cada uno
+// espera hasta timeout_ms a que existan los demás). prefix debe estar en un
+// directorio escribible, p.ej. /tmp/kohonen. Una vez conectados, cada
+// operación lanza una excepción si pasan io_timeout_ms sin poder enviar ni
+// recibir nada (un proceso colgado o muerto sin cerrar el socket); debe
+// cubrir la época más lenta, porque los demás la esperan dentro de
+// ringAllreduce. Un valor negativo espera sin límite.
+class UnixSocketTransport : public Transport {
+public:
+    UnixSocketTransport(const std::string& prefix, int rank, int size, int timeout_ms = 30000,
+                        int io_timeout_ms = 600000);
+    ~UnixSocketTransport() override;
+
+    UnixSocketTransport(const UnixSocketTransport&) = delete;
+    UnixSocketTransport& operator=(const UnixSocketTransport&) = delete;
+
+    int rank() const override { return rank_; }
+    int size() const override { return size_; }
+
+    void send(int peer, const void* data, std::size_t bytes) override;
+    void recv(int peer, void* data, std::size_t bytes) override;
+    void sendRecv(int to, const void* send_data, std::size_t send_bytes,
+                  int from, void* recv_data, std::size_t recv_bytes) override;
+
+private:
+    int peerSocket(int peer) const;
+
+    int rank_;
+    int size_;
+    int io_timeout_ms_;
+    std::string path_;
+    int listen_fd_ = -1;
+    std::vector<int> peers_;   // descriptor por rango; -1 para el propio
+};
+
+// Operaciones colectivas sobre cualquier Transport; todos los procesos deben
+// llamarlas en el mismo orden y con el mismo tamaño.
+
+// Suma elemento a elemento en anillo (reduce-scatter + allgather): cada
+// proceso envía y recibe 2 (N-1)/N del vector. Cada trozo se suma siempre en
+// el mismo orden y después se copia, así que todos los procesos terminan con
+// exactamente los mismos bits.
+void ringAllreduce(Transport& transport, float* data, std::size_t count);
+void ringAllreduce(Transport& transport, double* data, std::size_t count);
+
+// Copia data del proceso root a todos los demás, pasándolo por el anillo.
+void broadcast(Transport& transport, void* data, std::size_t bytes, int root = 0);
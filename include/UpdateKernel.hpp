@@ -0,0 +1,45 @@
+#pragma once
+
+#include "BMUSearch.hpp"
+#include "WeightMatrix.hpp"
+
+// Vecina de la BMU que se actualiza con la muestra y su tasa lr * h.
+struct NeighborUpdate {
+    int neuron;
+    float alpha;
+};
+
+// Actualización de Kohonen sobre la lista de vecinas de una muestra:
+// w = w + alpha (x - w), evaluado como w (1 - alpha) + alpha x (una FMA por
+// componente). Las filas se procesan en bloques de cuatro para reutilizar
+// cada carga de la entrada, y la variante applyAndScore calcula además, en
+// la misma pasada, la distancia de la muestra siguiente a cada fila ya
+// actualizada, sin volver a leerlas de memoria.
+//
+// El kernel se elige en tiempo de ejecución igual que en BMUSearch (y
+// respeta KOHONEN_SIMD). Las variantes AVX2 y AVX-512 escriben pesos
+// idénticos entre sí; SSE y escalar no usan FMA y pueden diferir en el
+// último bit. Las distancias de applyAndScore no coinciden entre AVX2 y
+// AVX-512 (8 carriles más una cola escalar frente a 16 carriles con
+// máscara), así que la pista de arranque en caliente puede cambiar de ISA
+// a ISA aunque los pesos sean los mismos.
+class UpdateKernel {
+public:
+    UpdateKernel();
+    explicit UpdateKernel(SimdLevel level);
+
+    void apply(WeightMatrix& codebook, const float* input, const NeighborUpdate* updates, int count) const;
+    // Devuelve la fila actualizada más cercana a next (index -1 si count es 0).
+    BMUResult applyAndScore(WeightMatrix& codebook, const float* input, const NeighborUpdate* updates, int count,
+                            const float* next) const;
+
+    SimdLevel level() const { return level_; }
+
+private:
+    // next == nullptr: sólo actualiza
+    using Kernel = BMUResult (*)(float* weights, int stride, int cols, const NeighborUpdate* updates, int count,
+                                 const float* input, const float* next);
+
+    SimdLevel level_;
+    Kernel kernel_;
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "AlignedBuffer.hpp"
+#include <cstddef>
+#include <memory>
+
+// Vista no propietaria sobre una fila (prototipo de una neurona) del codebook.
+class RowView {
+public:
+    RowView() = default;
+    RowView(const float* data, int size) : data_(data), size_(size) {}
+
+    const float* data() const { return data_; }
+    int size() const { return size_; }
+    const float* begin() const { return data_; }
+    const float* end() const { return data_ + size_; }
+    float operator[](int i) const { return data_[i]; }
+
+private:
+    const float* data_ = nullptr;
+    int size_ = 0;
+};
+
+// Matriz contigua (neuronas x input_dim) alineada a 64 bytes. Cada fila se
+// rellena con ceros hasta un múltiplo de kRowAlignment floats, de modo que
+// todas las filas empiezan alineadas a línea de caché. También puede envolver
+// memoria externa con ese mismo formato (p.ej. un checkpoint proyectado con
+// mmap); owner mantiene viva esa memoria mientras la matriz exista.
+class WeightMatrix {
+public:
+    static constexpr std::size_t kAlignment = AlignedBuffer<float>::kAlignment;
+    static constexpr int kRowAlignment = static_cast<int>(kAlignment / sizeof(float));
+
+    WeightMatrix() = default;
+    WeightMatrix(int rows, int cols);
+
+    WeightMatrix(const WeightMatrix& other);
+    WeightMatrix& operator=(const WeightMatrix& other);
+    WeightMatrix(WeightMatrix&&) noexcept = default;
+    WeightMatrix& operator=(WeightMatrix&&) noexcept = default;
+
+    // data debe estar alineado a kAlignment y tener rows * paddedStride(cols) floats.
+    static WeightMatrix wrap(int rows, int cols, float* data, std::shared_ptr<void> owner);
+    bool isExternal() const { return owner_ != nullptr; }
+
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+    int stride() const { return stride_; }
+
+    float* data() { return ptr_; }
+    const float* data() const { return ptr_; }
+    std::size_t sizeBytes() const { return static_cast<std::size_t>(rows_) * stride_ * sizeof(float); }
+
+    float* row(int i) { return ptr_ + static_cast<std::size_t>(i) * stride_; }
+    const float* row(int i) const { return ptr_ + static_cast<std::size_t>(i) * stride_; }
+    RowView rowView(int i) const { return RowView(row(i), cols_); }
+
+    static int paddedStride(int cols);
+
+private:
+    int rows_ = 0;
+    int cols_ = 0;
+    int stride_ = 0;
+    float* ptr_ = nullptr;
+    AlignedBuffer<float> storage_;
+    std::shared_ptr<void> owner_;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "WeightMatrix.hpp"
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Instantáneas del codebook con doble búfer para observar un entrenamiento en
+// curso desde otro hilo. El entrenador marca las neuronas que modifica y
+// publica cada cierto número de muestras: sólo se copian las filas marcadas
+// al búfer trasero, que después se intercambia con el delantero. El lector
+// recibe la última instantánea junto con las neuronas que han cambiado desde
+// su lectura anterior, así que puede actualizar sólo esas.
+//
+// El entrenador nunca espera al lector: si éste retiene el búfer delantero,
+// la publicación se aplaza y los cambios se acumulan para la siguiente.
+class WeightSnapshot {
+public:
+    explicit WeightSnapshot(const WeightMatrix& weights);
+
+    WeightSnapshot(const WeightSnapshot&) = delete;
+    WeightSnapshot& operator=(const WeightSnapshot&) = delete;
+
+    // --- hilo del entrenador ---
+    void markDirty(int neuron) { dirty_[neuron] = kAllFlags; }
+    void markAllDirty();
+    // Devuelve false si el lector retiene el búfer delantero.
+    bool publish(const WeightMatrix& weights);
+
+    // --- hilo lector ---
+    // Última instantánea publicada y neuronas cambiadas desde el anterior
+    // acquire(), o nullptr si no hay nada nuevo. El búfer es válido hasta
+    // release().
+    const WeightMatrix* acquire(std::vector<int>& changed);
+    void release();
+
+    int version() const;
+
+private:
+    // bit b: la fila del búfer b está desfasada; kUnpublished: el lector aún
+    // no ha visto el cambio
+    static constexpr uint8_t kUnpublished = 4;
+    static constexpr uint8_t kAllFlags = 1 | 2 | kUnpublished;
+
+    WeightMatrix buffers_[2];
+    std::vector<uint8_t> dirty_;      // sólo lo toca el entrenador
+
+    mutable std::mutex mutex_;
+    std::vector<uint8_t> pending_;    // cambios publicados y no leídos
+    int front_ = 0;
+    int version_ = 0;
+    bool fresh_ = false;
+    bool reading_ = false;
+};
@@ -11,8 +11,8 @@ function compilar() {
 
 function ejecutar_tests() {
     echo "== Ejecutando tests =="
-    if [ ! -d build ]; then
-        echo "No existe la carpeta build, compilando primero..."
+    if [ ! -f build/simd_kernels_test ]; then
+        echo "No están compiladas las pruebas, compilando primero..."
         compilar
     fi
     cd build
@@ -20,9 +20,19 @@ function ejecutar_tests() {
     cd ..
 }
 
+function ejecutar_bench() {
+    echo "== Ejecutando benchmarks =="
+    if [ ! -f build/kohonen_bench ]; then
+        echo "No está compilado kohonen_bench, compilando primero..."
+        compilar
+    fi
+    ./build/kohonen_bench --benchmark_out=bench_output.json --benchmark_out_format=json
+    echo "Resultados en bench_output.json"
+}
+
 function ejecutar_main() {
-    echo "== Ejecutando alineador =="
-    if [ ! -f build/alineador ]; then
+    echo "== Ejecutando kohonen_visualizer =="
+    if [ ! -f build/kohonen_visualizer ]; then
         echo "No está compilado el ejecutable, compilando primero..."
         compilar
     fi
@@ -30,7 +40,7 @@ function ejecutar_main() {
 }
 
 if [ $# -eq 0 ]; then
-    echo "Uso: $0 {build|test|run}"
+    echo "Uso: $0 {build|test|bench|main}"
     exit 1
 fi
 
@@ -41,11 +51,14 @@ case $1 in
     test)
         ejecutar_tests
         ;;
+    bench)
+        ejecutar_bench
+        ;;
     main)
         ejecutar_main
         ;;
     *)
-        echo "Opción no válida. Usa: build, test, o run"
+        echo "Opción no válida. Usa: build, test, bench o main"
         exit 1
         ;;
 esac
\ No newline at end of file
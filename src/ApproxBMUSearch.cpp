@@ -0,0 +1,167 @@
+#include "ApproxBMUSearch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+constexpr int kMaxHillClimbSteps = 64;
+constexpr int kMaxBeamWidth = 32;
+
+}
+
+ApproxBMUSearch::ApproxBMUSearch(const WeightMatrix& codebook, const LatticeShape& lattice,
+                                 const ApproxBMUOptions& options)
+    : codebook_(codebook), lattice_(lattice), options_(options) {
+    options_.beamWidth = std::min(kMaxBeamWidth, std::max(1, options_.beamWidth));
+    levels_.push_back({lattice.sizeX, lattice.sizeY, lattice.sizeZ, WeightMatrix()});
+    while (true) {
+        const Level& last = levels_.back();
+        int neurons = last.sizeX * last.sizeY * last.sizeZ;
+        if (neurons <= options_.topLevelNeurons || (last.sizeX == 1 && last.sizeY == 1 && last.sizeZ == 1)) break;
+        int nx = (last.sizeX + 1) / 2, ny = (last.sizeY + 1) / 2, nz = (last.sizeZ + 1) / 2;
+        levels_.push_back({nx, ny, nz, WeightMatrix(nx * ny * nz, codebook.cols())});
+    }
+    rebuild();
+}
+
+const WeightMatrix& ApproxBMUSearch::levelWeights(int level) const {
+    return level == 0 ? codebook_ : levels_[level].prototypes;
+}
+
+void ApproxBMUSearch::rebuild() {
+    int cols = codebook_.cols();
+    for (std::size_t l = 1; l < levels_.size(); l++) {
+        const Level& fine = levels_[l - 1];
+        const WeightMatrix& fine_weights = levelWeights(static_cast<int>(l) - 1);
+        Level& coarse = levels_[l];
+        for (int x = 0; x < coarse.sizeX; x++) {
+            for (int y = 0; y < coarse.sizeY; y++) {
+                for (int z = 0; z < coarse.sizeZ; z++) {
+                    float* out = coarse.prototypes.row((x * coarse.sizeY + y) * coarse.sizeZ + z);
+                    std::fill(out, out + cols, 0.0f);
+                    int children = 0;
+                    for (int cx = 2 * x; cx <= std::min(2 * x + 1, fine.sizeX - 1); cx++) {
+                        for (int cy = 2 * y; cy <= std::min(2 * y + 1, fine.sizeY - 1); cy++) {
+                            for (int cz = 2 * z; cz <= std::min(2 * z + 1, fine.sizeZ - 1); cz++) {
+                                const float* w = fine_weights.row((cx * fine.sizeY + cy) * fine.sizeZ + cz);
+                                for (int j = 0; j < cols; j++) out[j] += w[j];
+                                children++;
+                            }
+                        }
+                    }
+                    float inv = 1.0f / children;
+                    for (int j = 0; j < cols; j++) out[j] *= inv;
+                }
+            }
+        }
+    }
+}
+
+float ApproxBMUSearch::distance(int level, int index, const float* input) const {
+    return search_.find(levelWeights(level), input, index, index + 1).distance;
+}
+
+BMUResult ApproxBMUSearch::findExact(const float* input) const {
+    return search_.find(codebook_, input);
+}
+
+BMUResult ApproxBMUSearch::find(const float* input, int hint) const {
+    if (exhaustive_ || levels_.size() == 1) return findExact(input);
+
+    // los haces viven en la pila: find() se llama una vez por muestra
+    int beam_width = options_.beamWidth;
+    Candidate beam_storage[kMaxBeamWidth], next_storage[kMaxBeamWidth];
+    Candidate* beam = beam_storage;
+    Candidate* next = next_storage;
+    int beam_size = 0, next_size = 0;
+
+    // inserción ordenada por distancia, conservando los beam_width mejores
+    auto offer = [&](Candidate* list, int& size, Candidate c) {
+        if (size == beam_width && c.distance >= list[size - 1].distance) return;
+        int pos = size < beam_width ? size++ : size - 1;
+        while (pos > 0 && list[pos - 1].distance > c.distance) {
+            list[pos] = list[pos - 1];
+            pos--;
+        }
+        list[pos] = c;
+    };
+
+    // nivel más grueso: exhaustivo
+    int top = static_cast<int>(levels_.size()) - 1;
+    const Level& top_level = levels_[top];
+    int top_neurons = top_level.sizeX * top_level.sizeY * top_level.sizeZ;
+    for (int i = 0; i < top_neurons; i++) offer(beam, beam_size, {i, distance(top, i, input)});
+
+    // descenso: se exploran sólo los hijos de los nodos del haz
+    for (int l = top - 1; l >= 0; l--) {
+        const Level& fine = levels_[l];
+        const Level& coarse = levels_[l + 1];
+        next_size = 0;
+        for (int b = 0; b < beam_size; b++) {
+            const Candidate& parent = beam[b];
+            int px = parent.index / (coarse.sizeY * coarse.sizeZ);
+            int py = (parent.index / coarse.sizeZ) % coarse.sizeY;
+            int pz = parent.index % coarse.sizeZ;
+            for (int cx = 2 * px; cx <= std::min(2 * px + 1, fine.sizeX - 1); cx++) {
+                for (int cy = 2 * py; cy <= std::min(2 * py + 1, fine.sizeY - 1); cy++) {
+                    for (int cz = 2 * pz; cz <= std::min(2 * pz + 1, fine.sizeZ - 1); cz++) {
+                        int child = (cx * fine.sizeY + cy) * fine.sizeZ + cz;
+                        offer(next, next_size, {child, distance(l, child, input)});
+                    }
+                }
+            }
+        }
+        std::swap(beam, next);
+        std::swap(beam_size, next_size);
+    }
+
+    BMUResult best = hillClimb(input, {beam[0].index, beam[0].distance});
+    if (options_.warmStart && hint >= 0 && hint != best.index) {
+        BMUResult warm = hillClimb(input, {hint, distance(0, hint, input)});
+        if (warm.distance < best.distance) best = warm;
+    }
+    return best;
+}
+
+// Desciende por la red mientras alguna vecina (según la topología) esté más cerca.
+BMUResult ApproxBMUSearch::hillClimb(const float* input, BMUResult start) const {
+    BMUResult current = start;
+    for (int step = 0; step < kMaxHillClimbSteps; step++) {
+        BMUResult best = current;
+        lattice_.forEachAdjacent(current.index, [&](int n) {
+            float d = distance(0, n, input);
+            if (d < best.distance) best = {n, d};
+        });
+        if (best.index == current.index) break;
+        current = best;
+    }
+    return current;
+}
+
+RecallReport ApproxBMUSearch::measureRecall(const std::vector<const float*>& samples) {
+    RecallReport report;
+    report.samples = static_cast<int>(samples.size());
+    if (samples.empty() || levels_.size() == 1) {
+        report.recall = 1.0f;
+        exhaustive_ = false;
+        return report;
+    }
+
+    exhaustive_ = false;
+    int hits = 0;
+    double approx_sum = 0.0, exact_sum = 0.0;
+    int hint = -1;
+    for (const float* x : samples) {
+        BMUResult approx = find(x, hint);
+        BMUResult exact = findExact(x);
+        if (approx.index == exact.index) hits++;
+        approx_sum += std::sqrt(approx.distance);
+        exact_sum += std::sqrt(exact.distance);
+        hint = approx.index;
+    }
+    report.recall = static_cast<float>(hits) / samples.size();
+    report.distanceRatio = exact_sum > 0.0 ? static_cast<float>(approx_sum / exact_sum) : 1.0f;
+    exhaustive_ = report.recall < options_.minRecall;
+    return report;
+}
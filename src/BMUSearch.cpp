@@ -0,0 +1,383 @@
+#include "BMUSearch.hpp"
+#include <cfloat>
+#include <cstdlib>
+#include <cstring>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define KOHONEN_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+BMUResult bmuScalar(const float* weights, int stride, int cols, int begin, int end, const float* input) {
+    BMUResult best{begin < end ? begin : -1, FLT_MAX};
+    for (int i = begin; i < end; i++) {
+        const float* w = weights + static_cast<std::size_t>(i) * stride;
+        float dist = 0.0f;
+        for (int j = 0; j < cols; j++) {
+            float diff = input[j] - w[j];
+            dist += diff * diff;
+        }
+        best.consider(i, dist);
+    }
+    return best;
+}
+
+BMUResult bmuBytesScalar(const float* weights, int stride, int cols, int begin, int end,
+                         const uint8_t* input, float scale) {
+    BMUResult best{begin < end ? begin : -1, FLT_MAX};
+    for (int i = begin; i < end; i++) {
+        const float* w = weights + static_cast<std::size_t>(i) * stride;
+        float dist = 0.0f;
+        for (int j = 0; j < cols; j++) {
+            float diff = input[j] * scale - w[j];
+            dist += diff * diff;
+        }
+        best.consider(i, dist);
+    }
+    return best;
+}
+
+#ifdef KOHONEN_X86
+
+inline void updateBest(BMUResult& best, const float* d, int first, int count) {
+    for (int k = 0; k < count; k++) best.consider(first + k, d[k]);
+}
+
+// Los kernels vectoriales procesan cuatro neuronas a la vez para reutilizar
+// cada carga de la entrada y hacen una única reducción horizontal por bloque.
+
+BMUResult bmuSSE(const float* weights, int stride, int cols, int begin, int end, const float* input) {
+    BMUResult best{begin < end ? begin : -1, FLT_MAX};
+    int vec_cols = cols & ~3;
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        const float* w0 = weights + static_cast<std::size_t>(i) * stride;
+        const float* w1 = w0 + stride;
+        const float* w2 = w1 + stride;
+        const float* w3 = w2 + stride;
+        __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+        __m128 a2 = _mm_setzero_ps(), a3 = _mm_setzero_ps();
+        int j = 0;
+        for (; j < vec_cols; j += 4) {
+            __m128 x = _mm_loadu_ps(input + j);
+            __m128 d0 = _mm_sub_ps(x, _mm_load_ps(w0 + j));
+            __m128 d1 = _mm_sub_ps(x, _mm_load_ps(w1 + j));
+            __m128 d2 = _mm_sub_ps(x, _mm_load_ps(w2 + j));
+            __m128 d3 = _mm_sub_ps(x, _mm_load_ps(w3 + j));
+            a0 = _mm_add_ps(a0, _mm_mul_ps(d0, d0));
+            a1 = _mm_add_ps(a1, _mm_mul_ps(d1, d1));
+            a2 = _mm_add_ps(a2, _mm_mul_ps(d2, d2));
+            a3 = _mm_add_ps(a3, _mm_mul_ps(d3, d3));
+        }
+        // transponer y sumar: r[k] = suma horizontal de a_k
+        _MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+        __m128 r = _mm_add_ps(_mm_add_ps(a0, a1), _mm_add_ps(a2, a3));
+        alignas(16) float d[4];
+        _mm_store_ps(d, r);
+        for (; j < cols; j++) {
+            float x = input[j];
+            d[0] += (x - w0[j]) * (x - w0[j]);
+            d[1] += (x - w1[j]) * (x - w1[j]);
+            d[2] += (x - w2[j]) * (x - w2[j]);
+            d[3] += (x - w3[j]) * (x - w3[j]);
+        }
+        updateBest(best, d, i, 4);
+    }
+    for (; i < end; i++) {
+        const float* w = weights + static_cast<std::size_t>(i) * stride;
+        __m128 a = _mm_setzero_ps();
+        int j = 0;
+        for (; j < vec_cols; j += 4) {
+            __m128 diff = _mm_sub_ps(_mm_loadu_ps(input + j), _mm_load_ps(w + j));
+            a = _mm_add_ps(a, _mm_mul_ps(diff, diff));
+        }
+        a = _mm_add_ps(a, _mm_movehl_ps(a, a));
+        a = _mm_add_ss(a, _mm_shuffle_ps(a, a, 1));
+        float dist = _mm_cvtss_f32(a);
+        for (; j < cols; j++) dist += (input[j] - w[j]) * (input[j] - w[j]);
+        best.consider(i, dist);
+    }
+    return best;
+}
+
+__attribute__((target("avx2,fma")))
+BMUResult bmuAVX2(const float* weights, int stride, int cols, int begin, int end, const float* input) {
+    BMUResult best{begin < end ? begin : -1, FLT_MAX};
+    int vec_cols = cols & ~7;
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        const float* w0 = weights + static_cast<std::size_t>(i) * stride;
+        const float* w1 = w0 + stride;
+        const float* w2 = w1 + stride;
+        const float* w3 = w2 + stride;
+        __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+        __m256 a2 = _mm256_setzero_ps(), a3 = _mm256_setzero_ps();
+        int j = 0;
+        for (; j < vec_cols; j += 8) {
+            __m256 x = _mm256_loadu_ps(input + j);
+            __m256 d0 = _mm256_sub_ps(x, _mm256_load_ps(w0 + j));
+            __m256 d1 = _mm256_sub_ps(x, _mm256_load_ps(w1 + j));
+            __m256 d2 = _mm256_sub_ps(x, _mm256_load_ps(w2 + j));
+            __m256 d3 = _mm256_sub_ps(x, _mm256_load_ps(w3 + j));
+            a0 = _mm256_fmadd_ps(d0, d0, a0);
+            a1 = _mm256_fmadd_ps(d1, d1, a1);
+            a2 = _mm256_fmadd_ps(d2, d2, a2);
+            a3 = _mm256_fmadd_ps(d3, d3, a3);
+        }
+        __m256 s = _mm256_hadd_ps(_mm256_hadd_ps(a0, a1), _mm256_hadd_ps(a2, a3));
+        __m128 r = _mm_add_ps(_mm256_castps256_ps128(s), _mm256_extractf128_ps(s, 1));
+        alignas(16) float d[4];
+        _mm_store_ps(d, r);
+        for (; j < cols; j++) {
+            float x = input[j];
+            d[0] += (x - w0[j]) * (x - w0[j]);
+            d[1] += (x - w1[j]) * (x - w1[j]);
+            d[2] += (x - w2[j]) * (x - w2[j]);
+            d[3] += (x - w3[j]) * (x - w3[j]);
+        }
+        updateBest(best, d, i, 4);
+    }
+    for (; i < end; i++) {
+        const float* w = weights + static_cast<std::size_t>(i) * stride;
+        __m256 a = _mm256_setzero_ps();
+        int j = 0;
+        for (; j < vec_cols; j += 8) {
+            __m256 diff = _mm256_sub_ps(_mm256_loadu_ps(input + j), _mm256_load_ps(w + j));
+            a = _mm256_fmadd_ps(diff, diff, a);
+        }
+        __m128 r = _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+        r = _mm_add_ps(r, _mm_movehl_ps(r, r));
+        r = _mm_add_ss(r, _mm_shuffle_ps(r, r, 1));
+        float dist = _mm_cvtss_f32(r);
+        for (; j < cols; j++) dist += (input[j] - w[j]) * (input[j] - w[j]);
+        best.consider(i, dist);
+    }
+    return best;
+}
+
+__attribute__((target("avx512f")))
+BMUResult bmuAVX512(const float* weights, int stride, int cols, int begin, int end, const float* input) {
+    BMUResult best{begin < end ? begin : -1, FLT_MAX};
+    int vec_cols = cols & ~15;
+    __mmask16 tail = static_cast<__mmask16>((1u << (cols - vec_cols)) - 1);
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        const float* w0 = weights + static_cast<std::size_t>(i) * stride;
+        const float* w1 = w0 + stride;
+        const float* w2 = w1 + stride;
+        const float* w3 = w2 + stride;
+        __m512 a0 = _mm512_setzero_ps(), a1 = _mm512_setzero_ps();
+        __m512 a2 = _mm512_setzero_ps(), a3 = _mm512_setzero_ps();
+        int j = 0;
+        for (; j < vec_cols; j += 16) {
+            __m512 x = _mm512_loadu_ps(input + j);
+            __m512 d0 = _mm512_sub_ps(x, _mm512_load_ps(w0 + j));
+            __m512 d1 = _mm512_sub_ps(x, _mm512_load_ps(w1 + j));
+            __m512 d2 = _mm512_sub_ps(x, _mm512_load_ps(w2 + j));
+            __m512 d3 = _mm512_sub_ps(x, _mm512_load_ps(w3 + j));
+            a0 = _mm512_fmadd_ps(d0, d0, a0);
+            a1 = _mm512_fmadd_ps(d1, d1, a1);
+            a2 = _mm512_fmadd_ps(d2, d2, a2);
+            a3 = _mm512_fmadd_ps(d3, d3, a3);
+        }
+        if (tail) {
+            __m512 x = _mm512_maskz_loadu_ps(tail, input + j);
+            __m512 d0 = _mm512_sub_ps(x, _mm512_maskz_load_ps(tail, w0 + j));
+            __m512 d1 = _mm512_sub_ps(x, _mm512_maskz_load_ps(tail, w1 + j));
+            __m512 d2 = _mm512_sub_ps(x, _mm512_maskz_load_ps(tail, w2 + j));
+            __m512 d3 = _mm512_sub_ps(x, _mm512_maskz_load_ps(tail, w3 + j));
+            a0 = _mm512_fmadd_ps(d0, d0, a0);
+            a1 = _mm512_fmadd_ps(d1, d1, a1);
+            a2 = _mm512_fmadd_ps(d2, d2, a2);
+            a3 = _mm512_fmadd_ps(d3, d3, a3);
+        }
+        float d[4] = {_mm512_reduce_add_ps(a0), _mm512_reduce_add_ps(a1),
+                      _mm512_reduce_add_ps(a2), _mm512_reduce_add_ps(a3)};
+        updateBest(best, d, i, 4);
+    }
+    for (; i < end; i++) {
+        const float* w = weights + static_cast<std::size_t>(i) * stride;
+        __m512 a = _mm512_setzero_ps();
+        int j = 0;
+        for (; j < vec_cols; j += 16) {
+            __m512 diff = _mm512_sub_ps(_mm512_loadu_ps(input + j), _mm512_load_ps(w + j));
+            a = _mm512_fmadd_ps(diff, diff, a);
+        }
+        if (tail) {
+            __m512 diff = _mm512_sub_ps(_mm512_maskz_loadu_ps(tail, input + j), _mm512_maskz_load_ps(tail, w + j));
+            a = _mm512_fmadd_ps(diff, diff, a);
+        }
+        float dist = _mm512_reduce_add_ps(a);
+        best.consider(i, dist);
+    }
+    return best;
+}
+
+// Variantes para entrada en bytes: se expande u8 -> f32 y se escala en
+// registro, sin materializar la muestra en float.
+
+__attribute__((target("avx2,fma")))
+BMUResult bmuBytesAVX2(const float* weights, int stride, int cols, int begin, int end,
+                       const uint8_t* input, float scale) {
+    BMUResult best{begin < end ? begin : -1, FLT_MAX};
+    int vec_cols = cols & ~7;
+    __m256 vscale = _mm256_set1_ps(scale);
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        const float* w0 = weights + static_cast<std::size_t>(i) * stride;
+        const float* w1 = w0 + stride;
+        const float* w2 = w1 + stride;
+        const float* w3 = w2 + stride;
+        __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+        __m256 a2 = _mm256_setzero_ps(), a3 = _mm256_setzero_ps();
+        int j = 0;
+        for (; j < vec_cols; j += 8) {
+            __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(input + j));
+            __m256 x = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes)), vscale);
+            __m256 d0 = _mm256_sub_ps(x, _mm256_load_ps(w0 + j));
+            __m256 d1 = _mm256_sub_ps(x, _mm256_load_ps(w1 + j));
+            __m256 d2 = _mm256_sub_ps(x, _mm256_load_ps(w2 + j));
+            __m256 d3 = _mm256_sub_ps(x, _mm256_load_ps(w3 + j));
+            a0 = _mm256_fmadd_ps(d0, d0, a0);
+            a1 = _mm256_fmadd_ps(d1, d1, a1);
+            a2 = _mm256_fmadd_ps(d2, d2, a2);
+            a3 = _mm256_fmadd_ps(d3, d3, a3);
+        }
+        __m256 s = _mm256_hadd_ps(_mm256_hadd_ps(a0, a1), _mm256_hadd_ps(a2, a3));
+        __m128 r = _mm_add_ps(_mm256_castps256_ps128(s), _mm256_extractf128_ps(s, 1));
+        alignas(16) float d[4];
+        _mm_store_ps(d, r);
+        for (; j < cols; j++) {
+            float x = input[j] * scale;
+            d[0] += (x - w0[j]) * (x - w0[j]);
+            d[1] += (x - w1[j]) * (x - w1[j]);
+            d[2] += (x - w2[j]) * (x - w2[j]);
+            d[3] += (x - w3[j]) * (x - w3[j]);
+        }
+        updateBest(best, d, i, 4);
+    }
+    if (i < end) {
+        BMUResult rest = bmuBytesScalar(weights, stride, cols, i, end, input, scale);
+        best.merge(rest);
+    }
+    return best;
+}
+
+__attribute__((target("avx512f")))
+BMUResult bmuBytesAVX512(const float* weights, int stride, int cols, int begin, int end,
+                         const uint8_t* input, float scale) {
+    BMUResult best{begin < end ? begin : -1, FLT_MAX};
+    int vec_cols = cols & ~15;
+    __m512 vscale = _mm512_set1_ps(scale);
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        const float* w0 = weights + static_cast<std::size_t>(i) * stride;
+        const float* w1 = w0 + stride;
+        const float* w2 = w1 + stride;
+        const float* w3 = w2 + stride;
+        __m512 a0 = _mm512_setzero_ps(), a1 = _mm512_setzero_ps();
+        __m512 a2 = _mm512_setzero_ps(), a3 = _mm512_setzero_ps();
+        int j = 0;
+        for (; j < vec_cols; j += 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + j));
+            __m512 x = _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(bytes)), vscale);
+            __m512 d0 = _mm512_sub_ps(x, _mm512_load_ps(w0 + j));
+            __m512 d1 = _mm512_sub_ps(x, _mm512_load_ps(w1 + j));
+            __m512 d2 = _mm512_sub_ps(x, _mm512_load_ps(w2 + j));
+            __m512 d3 = _mm512_sub_ps(x, _mm512_load_ps(w3 + j));
+            a0 = _mm512_fmadd_ps(d0, d0, a0);
+            a1 = _mm512_fmadd_ps(d1, d1, a1);
+            a2 = _mm512_fmadd_ps(d2, d2, a2);
+            a3 = _mm512_fmadd_ps(d3, d3, a3);
+        }
+        float d[4] = {_mm512_reduce_add_ps(a0), _mm512_reduce_add_ps(a1),
+                      _mm512_reduce_add_ps(a2), _mm512_reduce_add_ps(a3)};
+        for (; j < cols; j++) {
+            float x = input[j] * scale;
+            d[0] += (x - w0[j]) * (x - w0[j]);
+            d[1] += (x - w1[j]) * (x - w1[j]);
+            d[2] += (x - w2[j]) * (x - w2[j]);
+            d[3] += (x - w3[j]) * (x - w3[j]);
+        }
+        updateBest(best, d, i, 4);
+    }
+    if (i < end) {
+        BMUResult rest = bmuBytesScalar(weights, stride, cols, i, end, input, scale);
+        best.merge(rest);
+    }
+    return best;
+}
+
+#endif
+
+SimdLevel levelFromEnv(SimdLevel detected) {
+    const char* env = std::getenv("KOHONEN_SIMD");
+    if (!env) return detected;
+    SimdLevel requested = detected;
+    if (std::strcmp(env, "scalar") == 0) requested = SimdLevel::Scalar;
+    else if (std::strcmp(env, "sse") == 0) requested = SimdLevel::SSE;
+    else if (std::strcmp(env, "avx2") == 0) requested = SimdLevel::AVX2;
+    else if (std::strcmp(env, "avx512") == 0) requested = SimdLevel::AVX512;
+    // nunca se eleva por encima de lo que soporta la CPU
+    return requested < detected ? requested : detected;
+}
+
+}
+
+SimdLevel BMUSearch::detectSimdLevel() {
+    static const SimdLevel level = [] {
+        SimdLevel detected = SimdLevel::Scalar;
+#ifdef KOHONEN_X86
+        __builtin_cpu_init();
+        detected = SimdLevel::SSE;
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) detected = SimdLevel::AVX2;
+        if (__builtin_cpu_supports("avx512f")) detected = SimdLevel::AVX512;
+#endif
+        return levelFromEnv(detected);
+    }();
+    return level;
+}
+
+const char* BMUSearch::simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return "scalar";
+        case SimdLevel::SSE: return "sse";
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+BMUSearch::BMUSearch() : BMUSearch(detectSimdLevel()) {}
+
+BMUSearch::BMUSearch(SimdLevel level) : level_(level), kernel_(bmuScalar), byteKernel_(bmuBytesScalar) {
+    if (level_ > detectSimdLevel()) level_ = detectSimdLevel();
+#ifdef KOHONEN_X86
+    switch (level_) {
+        case SimdLevel::Scalar: kernel_ = bmuScalar; break;
+        case SimdLevel::SSE: kernel_ = bmuSSE; break;
+        case SimdLevel::AVX2: kernel_ = bmuAVX2; break;
+        case SimdLevel::AVX512: kernel_ = bmuAVX512; break;
+    }
+    // para bytes no hay variante SSE: se usa el kernel escalar
+    if (level_ == SimdLevel::AVX2) byteKernel_ = bmuBytesAVX2;
+    if (level_ == SimdLevel::AVX512) byteKernel_ = bmuBytesAVX512;
+#else
+    level_ = SimdLevel::Scalar;
+#endif
+}
+
+BMUResult BMUSearch::find(const WeightMatrix& codebook, const float* input) const {
+    return kernel_(codebook.data(), codebook.stride(), codebook.cols(), 0, codebook.rows(), input);
+}
+
+BMUResult BMUSearch::find(const WeightMatrix& codebook, const float* input, int begin, int end) const {
+    return kernel_(codebook.data(), codebook.stride(), codebook.cols(), begin, end, input);
+}
+
+BMUResult BMUSearch::find(const WeightMatrix& codebook, const uint8_t* input, float scale) const {
+    return byteKernel_(codebook.data(), codebook.stride(), codebook.cols(), 0, codebook.rows(), input, scale);
+}
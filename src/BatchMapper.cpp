@@ -0,0 +1,381 @@
+#include "BatchMapper.hpp"
+#include "AlignedBuffer.hpp"
+#include "Parallel.hpp"
+#include "PrefetchReader.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define KOHONEN_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Todos los kernels calculan out[s * ld + n] = x_s · w_n para nx muestras y
+// nw neuronas. Muestras y pesos tienen el mismo stride, múltiplo de 16 y
+// relleno con ceros, así que no hay cola que tratar en la dimensión.
+
+void dotsScalar(const float* x, int nx, const float* w, int nw, int stride, float* out, int ld) {
+    for (int s = 0; s < nx; s++) {
+        const float* xs = x + static_cast<std::size_t>(s) * stride;
+        for (int n = 0; n < nw; n++) {
+            const float* wn = w + static_cast<std::size_t>(n) * stride;
+            float dot = 0.0f;
+            for (int j = 0; j < stride; j++) dot += xs[j] * wn[j];
+            out[s * ld + n] = dot;
+        }
+    }
+}
+
+#ifdef KOHONEN_X86
+
+inline float hsum128(__m128 v) {
+    __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+}
+
+// Reduce cuatro acumuladores a la vez: {sum(a), sum(b), sum(c), sum(d)}.
+inline __m128 hsum4x128(__m128 a, __m128 b, __m128 c, __m128 d) {
+    _MM_TRANSPOSE4_PS(a, b, c, d);
+    return _mm_add_ps(_mm_add_ps(a, b), _mm_add_ps(c, d));
+}
+
+// Micro-kernel de 2 muestras x 4 neuronas: 8 acumuladores, y cada carga de
+// la entrada se usa con cuatro neuronas y cada carga de pesos con dos muestras.
+void dotsSSE(const float* x, int nx, const float* w, int nw, int stride, float* out, int ld) {
+    for (int s = 0; s < nx; s += 2) {
+        const float* x0 = x + static_cast<std::size_t>(s) * stride;
+        const float* x1 = x0 + stride;
+        float* o0 = out + s * ld;
+        float* o1 = o0 + ld;
+        int n = 0;
+        for (; n + 4 <= nw; n += 4) {
+            const float* w0 = w + static_cast<std::size_t>(n) * stride;
+            const float* w1 = w0 + stride;
+            const float* w2 = w1 + stride;
+            const float* w3 = w2 + stride;
+            __m128 a00 = _mm_setzero_ps(), a01 = _mm_setzero_ps(), a02 = _mm_setzero_ps(), a03 = _mm_setzero_ps();
+            __m128 a10 = _mm_setzero_ps(), a11 = _mm_setzero_ps(), a12 = _mm_setzero_ps(), a13 = _mm_setzero_ps();
+            for (int j = 0; j < stride; j += 4) {
+                __m128 xa = _mm_load_ps(x0 + j), xb = _mm_load_ps(x1 + j);
+                __m128 v0 = _mm_load_ps(w0 + j), v1 = _mm_load_ps(w1 + j);
+                __m128 v2 = _mm_load_ps(w2 + j), v3 = _mm_load_ps(w3 + j);
+                a00 = _mm_add_ps(a00, _mm_mul_ps(xa, v0));
+                a01 = _mm_add_ps(a01, _mm_mul_ps(xa, v1));
+                a02 = _mm_add_ps(a02, _mm_mul_ps(xa, v2));
+                a03 = _mm_add_ps(a03, _mm_mul_ps(xa, v3));
+                a10 = _mm_add_ps(a10, _mm_mul_ps(xb, v0));
+                a11 = _mm_add_ps(a11, _mm_mul_ps(xb, v1));
+                a12 = _mm_add_ps(a12, _mm_mul_ps(xb, v2));
+                a13 = _mm_add_ps(a13, _mm_mul_ps(xb, v3));
+            }
+            _mm_storeu_ps(o0 + n, hsum4x128(a00, a01, a02, a03));
+            _mm_storeu_ps(o1 + n, hsum4x128(a10, a11, a12, a13));
+        }
+        for (; n < nw; n++) {
+            const float* wn = w + static_cast<std::size_t>(n) * stride;
+            __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+            for (int j = 0; j < stride; j += 4) {
+                __m128 v = _mm_load_ps(wn + j);
+                a0 = _mm_add_ps(a0, _mm_mul_ps(_mm_load_ps(x0 + j), v));
+                a1 = _mm_add_ps(a1, _mm_mul_ps(_mm_load_ps(x1 + j), v));
+            }
+            o0[n] = hsum128(a0);
+            o1[n] = hsum128(a1);
+        }
+    }
+}
+
+__attribute__((target("avx2,fma")))
+inline __m128 hsum4x256(__m256 a, __m256 b, __m256 c, __m256 d) {
+    __m256 ab = _mm256_hadd_ps(a, b);
+    __m256 cd = _mm256_hadd_ps(c, d);
+    __m256 abcd = _mm256_hadd_ps(ab, cd);
+    return _mm_add_ps(_mm256_castps256_ps128(abcd), _mm256_extractf128_ps(abcd, 1));
+}
+
+__attribute__((target("avx2,fma")))
+inline float hsum256(__m256 v) {
+    __m128 lo = _mm256_castps256_ps128(v);
+    __m128 hi = _mm256_extractf128_ps(v, 1);
+    return hsum128(_mm_add_ps(lo, hi));
+}
+
+// Suma de las dos mitades de un __m512 (sin AVX-512DQ).
+__attribute__((target("avx512f")))
+inline __m256 halvesSum(__m512 v) {
+    __m256 hi = _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(v), 1));
+    return _mm256_add_ps(_mm512_castps512_ps256(v), hi);
+}
+
+__attribute__((target("avx512f")))
+inline __m128 hsum4x512(__m512 a, __m512 b, __m512 c, __m512 d) {
+    // sumar mitades deja cuatro __m256 y se sigue como en AVX2
+    __m256 a8 = halvesSum(a), b8 = halvesSum(b), c8 = halvesSum(c), d8 = halvesSum(d);
+    __m256 abcd = _mm256_hadd_ps(_mm256_hadd_ps(a8, b8), _mm256_hadd_ps(c8, d8));
+    return _mm_add_ps(_mm256_castps256_ps128(abcd), _mm256_extractf128_ps(abcd, 1));
+}
+
+// Mismo esquema que dotsSSE con registros de 8 floats y FMA (11 de los 16
+// registros ymm).
+__attribute__((target("avx2,fma")))
+void dotsAVX2(const float* x, int nx, const float* w, int nw, int stride, float* out, int ld) {
+    for (int s = 0; s < nx; s += 2) {
+        const float* x0 = x + static_cast<std::size_t>(s) * stride;
+        const float* x1 = x0 + stride;
+        float* o0 = out + s * ld;
+        float* o1 = o0 + ld;
+        int n = 0;
+        for (; n + 4 <= nw; n += 4) {
+            const float* w0 = w + static_cast<std::size_t>(n) * stride;
+            const float* w1 = w0 + stride;
+            const float* w2 = w1 + stride;
+            const float* w3 = w2 + stride;
+            __m256 a00 = _mm256_setzero_ps(), a01 = _mm256_setzero_ps(), a02 = _mm256_setzero_ps(), a03 = _mm256_setzero_ps();
+            __m256 a10 = _mm256_setzero_ps(), a11 = _mm256_setzero_ps(), a12 = _mm256_setzero_ps(), a13 = _mm256_setzero_ps();
+            for (int j = 0; j < stride; j += 8) {
+                __m256 xa = _mm256_load_ps(x0 + j), xb = _mm256_load_ps(x1 + j);
+                __m256 v = _mm256_load_ps(w0 + j);
+                a00 = _mm256_fmadd_ps(xa, v, a00);
+                a10 = _mm256_fmadd_ps(xb, v, a10);
+                v = _mm256_load_ps(w1 + j);
+                a01 = _mm256_fmadd_ps(xa, v, a01);
+                a11 = _mm256_fmadd_ps(xb, v, a11);
+                v = _mm256_load_ps(w2 + j);
+                a02 = _mm256_fmadd_ps(xa, v, a02);
+                a12 = _mm256_fmadd_ps(xb, v, a12);
+                v = _mm256_load_ps(w3 + j);
+                a03 = _mm256_fmadd_ps(xa, v, a03);
+                a13 = _mm256_fmadd_ps(xb, v, a13);
+            }
+            _mm_storeu_ps(o0 + n, hsum4x256(a00, a01, a02, a03));
+            _mm_storeu_ps(o1 + n, hsum4x256(a10, a11, a12, a13));
+        }
+        for (; n < nw; n++) {
+            const float* wn = w + static_cast<std::size_t>(n) * stride;
+            __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+            for (int j = 0; j < stride; j += 8) {
+                __m256 v = _mm256_load_ps(wn + j);
+                a0 = _mm256_fmadd_ps(_mm256_load_ps(x0 + j), v, a0);
+                a1 = _mm256_fmadd_ps(_mm256_load_ps(x1 + j), v, a1);
+            }
+            o0[n] = hsum256(a0);
+            o1[n] = hsum256(a1);
+        }
+    }
+}
+
+// Con 32 registros zmm cabe un micro-kernel de 4 muestras x 4 neuronas:
+// 16 acumuladores, cuatro cargas de muestra y una de pesos por paso.
+__attribute__((target("avx512f")))
+void dotsAVX512(const float* x, int nx, const float* w, int nw, int stride, float* out, int ld) {
+    for (int s = 0; s < nx; s += 4) {
+        const float* x0 = x + static_cast<std::size_t>(s) * stride;
+        const float* x1 = x0 + stride;
+        const float* x2 = x1 + stride;
+        const float* x3 = x2 + stride;
+        float* o = out + s * ld;
+        int n = 0;
+        for (; n + 4 <= nw; n += 4) {
+            const float* wr[4];
+            for (int k = 0; k < 4; k++) wr[k] = w + static_cast<std::size_t>(n + k) * stride;
+            __m512 acc[4][4];
+            for (int a = 0; a < 4; a++) {
+                for (int b = 0; b < 4; b++) acc[a][b] = _mm512_setzero_ps();
+            }
+            for (int j = 0; j < stride; j += 16) {
+                __m512 xv[4] = {_mm512_load_ps(x0 + j), _mm512_load_ps(x1 + j),
+                                _mm512_load_ps(x2 + j), _mm512_load_ps(x3 + j)};
+                for (int b = 0; b < 4; b++) {
+                    __m512 v = _mm512_load_ps(wr[b] + j);
+                    for (int a = 0; a < 4; a++) acc[a][b] = _mm512_fmadd_ps(xv[a], v, acc[a][b]);
+                }
+            }
+            for (int a = 0; a < 4; a++) {
+                _mm_storeu_ps(o + a * ld + n, hsum4x512(acc[a][0], acc[a][1], acc[a][2], acc[a][3]));
+            }
+        }
+        for (; n < nw; n++) {
+            const float* wn = w + static_cast<std::size_t>(n) * stride;
+            __m512 a0 = _mm512_setzero_ps(), a1 = _mm512_setzero_ps();
+            __m512 a2 = _mm512_setzero_ps(), a3 = _mm512_setzero_ps();
+            for (int j = 0; j < stride; j += 16) {
+                __m512 v = _mm512_load_ps(wn + j);
+                a0 = _mm512_fmadd_ps(_mm512_load_ps(x0 + j), v, a0);
+                a1 = _mm512_fmadd_ps(_mm512_load_ps(x1 + j), v, a1);
+                a2 = _mm512_fmadd_ps(_mm512_load_ps(x2 + j), v, a2);
+                a3 = _mm512_fmadd_ps(_mm512_load_ps(x3 + j), v, a3);
+            }
+            o[n] = _mm512_reduce_add_ps(a0);
+            o[ld + n] = _mm512_reduce_add_ps(a1);
+            o[2 * ld + n] = _mm512_reduce_add_ps(a2);
+            o[3 * ld + n] = _mm512_reduce_add_ps(a3);
+        }
+    }
+}
+
+#endif
+
+float exactDistance(const float* x, const float* w, int cols) {
+    float dist = 0.0f;
+    for (int j = 0; j < cols; j++) {
+        float diff = x[j] - w[j];
+        dist += diff * diff;
+    }
+    return dist;
+}
+
+}
+
+BatchMapper::BatchMapper(const WeightMatrix& codebook) : BatchMapper(codebook, BMUSearch::detectSimdLevel()) {}
+
+BatchMapper::BatchMapper(const WeightMatrix& codebook, SimdLevel level)
+    : codebook_(codebook), norms_(codebook.rows()), level_(level), kernel_(dotsScalar), kernelRows_(1) {
+    if (level_ > BMUSearch::detectSimdLevel()) level_ = BMUSearch::detectSimdLevel();
+#ifdef KOHONEN_X86
+    switch (level_) {
+        case SimdLevel::AVX512: kernel_ = dotsAVX512; kernelRows_ = 4; break;
+        case SimdLevel::AVX2:   kernel_ = dotsAVX2;   kernelRows_ = 2; break;
+        case SimdLevel::SSE:    kernel_ = dotsSSE;    kernelRows_ = 2; break;
+        case SimdLevel::Scalar: break;
+    }
+#else
+    level_ = SimdLevel::Scalar;
+#endif
+    for (int i = 0; i < codebook.rows(); i++) {
+        const float* w = codebook.row(i);
+        float norm = 0.0f;
+        for (int j = 0; j < codebook.cols(); j++) norm += w[j] * w[j];
+        norms_[i] = norm;
+    }
+}
+
+void BatchMapper::map(const float* samples, int count, std::size_t stride, MappedSample* out,
+                      const MappingOptions& options) const {
+    std::vector<const float*> rows(count);
+    for (int s = 0; s < count; s++) rows[s] = samples + s * stride;
+    mapRows(rows.data(), count, out, options);
+}
+
+std::vector<MappedSample> BatchMapper::map(const std::vector<std::vector<float>>& samples,
+                                           const MappingOptions& options) const {
+    std::vector<const float*> rows(samples.size());
+    for (std::size_t s = 0; s < samples.size(); s++) {
+        if (static_cast<int>(samples[s].size()) != codebook_.cols()) {
+            throw std::runtime_error("Sample dimension does not match the codebook");
+        }
+        rows[s] = samples[s].data();
+    }
+    std::vector<MappedSample> result(samples.size());
+    mapRows(rows.data(), static_cast<int>(rows.size()), result.data(), options);
+    return result;
+}
+
+std::vector<MappedSample> BatchMapper::map(const std::vector<std::vector<float>>& samples,
+                                           const std::vector<int>& indices, const MappingOptions& options) const {
+    std::vector<const float*> rows(indices.size());
+    for (std::size_t k = 0; k < indices.size(); k++) {
+        const std::vector<float>& x = samples[indices[k]];
+        if (static_cast<int>(x.size()) != codebook_.cols()) {
+            throw std::runtime_error("Sample dimension does not match the codebook");
+        }
+        rows[k] = x.data();
+    }
+    std::vector<MappedSample> result(indices.size());
+    mapRows(rows.data(), static_cast<int>(rows.size()), result.data(), options);
+    return result;
+}
+
+std::vector<MappedSample> BatchMapper::map(SampleSource& source, const MappingOptions& options) const {
+    if (source.dim() != codebook_.cols()) throw std::runtime_error("Sample source dimension does not match the codebook");
+    std::vector<MappedSample> result;
+    PrefetchReader reader(source, options.chunkRows, options.prefetchDepth);
+    int rows = 0;
+    while (const float* chunk = reader.next(rows)) {
+        std::size_t offset = result.size();
+        result.resize(offset + rows);
+        map(chunk, rows, source.dim(), result.data() + offset, options);
+    }
+    return result;
+}
+
+void BatchMapper::mapRows(const float* const* rows, int count, MappedSample* out, const MappingOptions& options) const {
+    int neurons = codebook_.rows();
+    int cols = codebook_.cols();
+    int stride = codebook_.stride();
+    if (count <= 0) return;
+    if (neurons == 0) throw std::runtime_error("Cannot map samples onto an empty codebook");
+
+    // la tesela de muestras se redondea al tamaño del micro-kernel
+    int sample_block = std::max(1, options.sampleBlock);
+    sample_block = (sample_block + kernelRows_ - 1) / kernelRows_ * kernelRows_;
+    int neuron_block = std::max(1, std::min(options.neuronBlock, neurons));
+    int blocks = (count + sample_block - 1) / sample_block;
+
+    parallelFor(0, blocks, resolveThreadCount(options.threads), [&](int first_block, int last_block, int) {
+        // copia de las muestras con el stride del codebook y ceros de relleno
+        AlignedBuffer<float> xs(static_cast<std::size_t>(sample_block) * stride);
+        std::vector<float> dots(static_cast<std::size_t>(sample_block) * neuron_block);
+        std::vector<int> best(sample_block), second(sample_block);
+        std::vector<float> best_score(sample_block), second_score(sample_block);
+
+        for (int block = first_block; block < last_block; block++) {
+            int s0 = block * sample_block;
+            int nx = std::min(sample_block, count - s0);
+            int padded_nx = (nx + kernelRows_ - 1) / kernelRows_ * kernelRows_;
+            for (int s = 0; s < nx; s++) {
+                std::memcpy(xs.data() + static_cast<std::size_t>(s) * stride, rows[s0 + s], cols * sizeof(float));
+            }
+            if (padded_nx > nx) {
+                std::memset(xs.data() + static_cast<std::size_t>(nx) * stride, 0,
+                            static_cast<std::size_t>(padded_nx - nx) * stride * sizeof(float));
+            }
+            std::fill(best.begin(), best.end(), -1);
+            std::fill(second.begin(), second.end(), -1);
+            std::fill(best_score.begin(), best_score.end(), FLT_MAX);
+            std::fill(second_score.begin(), second_score.end(), FLT_MAX);
+
+            for (int n0 = 0; n0 < neurons; n0 += neuron_block) {
+                int nw = std::min(neuron_block, neurons - n0);
+                kernel_(xs.data(), padded_nx, codebook_.row(n0), nw, stride, dots.data(), neuron_block);
+                for (int s = 0; s < nx; s++) {
+                    const float* d = dots.data() + static_cast<std::size_t>(s) * neuron_block;
+                    for (int n = 0; n < nw; n++) {
+                        // ||w||² - 2 x·w: la distancia salvo la constante ||x||²
+                        float score = norms_[n0 + n] - 2.0f * d[n];
+                        if (score < second_score[s]) {
+                            if (score < best_score[s]) {
+                                second_score[s] = best_score[s];
+                                second[s] = best[s];
+                                best_score[s] = score;
+                                best[s] = n0 + n;
+                            } else {
+                                second_score[s] = score;
+                                second[s] = n0 + n;
+                            }
+                        }
+                    }
+                }
+            }
+
+            for (int s = 0; s < nx; s++) {
+                const float* x = xs.data() + static_cast<std::size_t>(s) * stride;
+                float best_dist = exactDistance(x, codebook_.row(best[s]), cols);
+                if (second[s] >= 0) {
+                    float second_dist = exactDistance(x, codebook_.row(second[s]), cols);
+                    if (second_dist < best_dist || (second_dist == best_dist && second[s] < best[s])) {
+                        std::swap(best[s], second[s]);
+                        best_dist = second_dist;
+                    }
+                }
+                out[s0 + s] = MappedSample{best[s], second[s], std::sqrt(best_dist)};
+            }
+        }
+    });
+}
@@ -0,0 +1,84 @@
+#include "CameraPath.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+float cameraFarPlane(float zoom, int size_x, int size_y, int size_z) {
+    const float kMinFar = 100.0f;
+    float sx = size_x, sy = size_y, sz = size_z;
+    return std::max(kMinFar, -zoom + 2.0f * std::sqrt(sx * sx + sy * sy + sz * sz));
+}
+
+CameraPath::CameraPath(std::vector<Camera> frames) : frames_(std::move(frames)) {}
+
+CameraPath CameraPath::orbit(const Camera& start, int frames, float degrees) {
+    std::vector<Camera> path(std::max(1, frames), start);
+    for (int i = 0; i < static_cast<int>(path.size()); i++) {
+        path[i].angleY = start.angleY + degrees * i / path.size();
+    }
+    return CameraPath(std::move(path));
+}
+
+CameraPath CameraPath::load(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file) throw std::runtime_error("Cannot open camera path file: " + filename);
+
+    std::vector<std::pair<int, Camera>> keys;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        std::size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#') continue;
+
+        std::istringstream fields(line);
+        int frame = 0;
+        Camera camera;
+        if (!(fields >> frame >> camera.zoom >> camera.angleX >> camera.angleY)) {
+            throw std::runtime_error("Invalid camera key at " + filename + ":" + std::to_string(line_number));
+        }
+        // fovY opcional; detrás sólo puede venir un comentario
+        std::string token;
+        if (fields >> token && token[0] != '#') {
+            std::size_t used = 0;
+            float fov = 0.0f;
+            try {
+                fov = std::stof(token, &used);
+            } catch (const std::exception&) {
+                used = 0;
+            }
+            if (used != token.size()) {
+                throw std::runtime_error("Invalid fovY at " + filename + ":" + std::to_string(line_number));
+            }
+            camera.fovY = fov;
+            if (fields >> token && token[0] != '#') {
+                throw std::runtime_error("Unexpected token '" + token + "' at " + filename + ":" +
+                                         std::to_string(line_number));
+            }
+        }
+        if (frame < 0 || (!keys.empty() && frame <= keys.back().first)) {
+            throw std::runtime_error("Camera keys out of order at " + filename + ":" + std::to_string(line_number));
+        }
+        keys.emplace_back(frame, camera);
+    }
+    if (keys.empty()) throw std::runtime_error("Camera path has no keys: " + filename);
+
+    std::vector<Camera> frames(keys.back().first + 1, keys.front().second);
+    for (std::size_t k = 0; k + 1 < keys.size(); k++) {
+        const auto& a = keys[k];
+        const auto& b = keys[k + 1];
+        for (int f = a.first; f <= b.first; f++) {
+            float t = static_cast<float>(f - a.first) / (b.first - a.first);
+            Camera& c = frames[f];
+            c.zoom = a.second.zoom + t * (b.second.zoom - a.second.zoom);
+            c.angleX = a.second.angleX + t * (b.second.angleX - a.second.angleX);
+            c.angleY = a.second.angleY + t * (b.second.angleY - a.second.angleY);
+            c.fovY = a.second.fovY + t * (b.second.fovY - a.second.fovY);
+        }
+    }
+    return CameraPath(std::move(frames));
+}
@@ -0,0 +1,97 @@
+#include "Checkpoint.hpp"
+#include "KohonenNetwork.hpp"
+#include "MappedFile.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+}
+
+void Kohonen3D::saveCheckpoint(const std::string& filename) const {
+    CheckpointHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kCheckpointMagic, sizeof(header.magic));
+    header.version = kCheckpointVersion;
+    header.headerSize = sizeof(CheckpointHeader);
+    header.byteOrder = kCheckpointByteOrder;
+    header.topology = static_cast<uint32_t>(lattice_.topology);
+    header.sizeX = lattice_.sizeX;
+    header.sizeY = lattice_.sizeY;
+    header.sizeZ = lattice_.sizeZ;
+    header.inputDim = input_dim_;
+    header.stride = weights_.stride();
+    header.epoch = epoch_;
+    header.totalEpochs = total_epochs_;
+    header.learningRateInitial = schedule_.learningRate.initial();
+    header.radiusInitial = schedule_.radius.initial();
+    header.schedule = schedule_known_ && schedule_.isClassicLinear() ? 0 : 1;
+    header.weightsOffset = alignUp(sizeof(CheckpointHeader), kCheckpointAlignment);
+    header.weightsBytes = weights_.sizeBytes();
+
+    // se escribe a un fichero temporal y se renombra, para no dejar nunca un
+    // checkpoint a medias si el proceso muere durante la escritura
+    std::string tmp = filename + ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        if (!file) throw std::runtime_error("Cannot create checkpoint file: " + tmp);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        std::vector<char> padding(header.weightsOffset - sizeof(header), 0);
+        file.write(padding.data(), padding.size());
+        file.write(reinterpret_cast<const char*>(weights_.data()), header.weightsBytes);
+        if (!file) throw std::runtime_error("Error writing checkpoint file: " + tmp);
+    }
+    if (std::rename(tmp.c_str(), filename.c_str()) != 0) {
+        throw std::runtime_error("Cannot rename checkpoint file to: " + filename);
+    }
+}
+
+Kohonen3D Kohonen3D::loadCheckpoint(const std::string& filename) {
+    auto file = std::make_shared<MappedFile>(filename, MappedFile::Mode::Private);
+    if (file->size() < sizeof(CheckpointHeader)) {
+        throw std::runtime_error("Checkpoint file is truncated: " + filename);
+    }
+
+    CheckpointHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, kCheckpointMagic, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("Not a Kohonen3D checkpoint: " + filename);
+    }
+    if (header.version != kCheckpointVersion || header.headerSize != sizeof(CheckpointHeader)) {
+        throw std::runtime_error("Unsupported checkpoint version in: " + filename);
+    }
+    if (header.byteOrder != kCheckpointByteOrder) {
+        throw std::runtime_error("Checkpoint was written with a different byte order: " + filename);
+    }
+    if (header.topology > static_cast<uint32_t>(LatticeTopology::BodyCentered)) {
+        throw std::runtime_error("Unsupported lattice topology in checkpoint: " + filename);
+    }
+    if (header.sizeX <= 0 || header.sizeY <= 0 || header.sizeZ <= 0 || header.inputDim <= 0 ||
+        header.stride != WeightMatrix::paddedStride(header.inputDim)) {
+        throw std::runtime_error("Invalid lattice dimensions in checkpoint: " + filename);
+    }
+
+    int neurons = header.sizeX * header.sizeY * header.sizeZ;
+    uint64_t expected = static_cast<uint64_t>(neurons) * header.stride * sizeof(float);
+    if (header.weightsOffset % kCheckpointAlignment != 0 || header.weightsBytes != expected ||
+        header.weightsOffset + header.weightsBytes > file->size()) {
+        throw std::runtime_error("Checkpoint weight block is inconsistent: " + filename);
+    }
+
+    float* weights = reinterpret_cast<float*>(file->mutableData() + header.weightsOffset);
+    LatticeShape lattice{header.sizeX, header.sizeY, header.sizeZ, static_cast<LatticeTopology>(header.topology)};
+    Kohonen3D net(lattice, header.inputDim, WeightMatrix::wrap(neurons, header.inputDim, weights, file));
+    net.epoch_ = header.epoch;
+    net.total_epochs_ = header.totalEpochs;
+    net.schedule_ = TrainingSchedule::linear(header.learningRateInitial, header.radiusInitial);
+    net.schedule_known_ = header.schedule == 0;
+    return net;
+}
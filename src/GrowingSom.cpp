@@ -0,0 +1,238 @@
+#include "GrowingSom.hpp"
+#include "SampleSource.hpp"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <stdexcept>
+
+GrowingSom::GrowingSom(const GrowingOptions& options) : options_(options) {
+    if (options.initialSize < 2) throw std::runtime_error("Growing maps must start with at least 2 neurons per axis");
+    if (options.maxDepth < 1 || options.epochsPerStep < 1) throw std::runtime_error("Invalid growing SOM options");
+}
+
+void GrowingSom::train(const std::vector<Vector>& data) {
+    if (data.empty()) throw std::runtime_error("Growing SOM needs training data");
+    maps_.clear();
+    int dim = static_cast<int>(data.front().size());
+
+    // QE0: distancia media de las muestras a su media
+    std::vector<double> mean(dim, 0.0);
+    for (const auto& x : data) {
+        for (int j = 0; j < dim; j++) mean[j] += x[j];
+    }
+    for (double& m : mean) m /= data.size();
+    double total = 0.0;
+    for (const auto& x : data) {
+        double d2 = 0.0;
+        for (int j = 0; j < dim; j++) d2 += (x[j] - mean[j]) * (x[j] - mean[j]);
+        total += std::sqrt(d2);
+    }
+    qe0_ = static_cast<float>(total / data.size());
+
+    // los mapas se crean por niveles; cada trabajo lleva los índices (en
+    // data) de las muestras que representaba la neurona padre
+    struct Job {
+        int parent, parentNeuron, depth;
+        float parentQe;
+        std::vector<int> samples;
+    };
+    std::deque<Job> pending;
+    pending.push_back({-1, -1, 0, qe0_, std::vector<int>(data.size())});
+    for (std::size_t s = 0; s < data.size(); s++) pending.front().samples[s] = static_cast<int>(s);
+
+    MappingOptions mapping;
+    mapping.threads = options_.threads;
+    while (!pending.empty()) {
+        Job job = std::move(pending.front());
+        pending.pop_front();
+
+        int id = static_cast<int>(maps_.size());
+        Kohonen3D net = growMap(data, job.samples, job.parentQe);
+        int neurons = net.getNumNeurons();
+        maps_.push_back({std::move(net), job.parent, job.parentNeuron, job.depth, std::vector<int>(neurons, -1)});
+        if (job.parent >= 0) maps_[job.parent].children[job.parentNeuron] = id;
+        if (job.depth + 1 >= options_.maxDepth) continue;
+
+        // neuronas que siguen representando mal sus muestras -> mapa hijo
+        std::vector<MappedSample> mapped = maps_[id].net.mapBatch(data, job.samples, mapping);
+        std::vector<double> error(neurons, 0.0);
+        std::vector<int> hits(neurons, 0);
+        for (const MappedSample& m : mapped) {
+            error[m.bmu] += m.quantizationError;
+            hits[m.bmu]++;
+        }
+        for (int i = 0; i < neurons; i++) {
+            if (hits[i] < options_.minSamplesPerMap) continue;
+            float neuron_qe = static_cast<float>(error[i] / hits[i]);
+            if (neuron_qe <= options_.depth * qe0_) continue;
+            Job child{id, i, job.depth + 1, neuron_qe, {}};
+            child.samples.reserve(hits[i]);
+            for (std::size_t s = 0; s < mapped.size(); s++) {
+                if (mapped[s].bmu == i) child.samples.push_back(job.samples[s]);
+            }
+            pending.push_back(std::move(child));
+        }
+    }
+}
+
+// Entrena un mapa e inserta planos mientras su error medio no baje de
+// breadth * parent_qe, siga mejorando y no se alcance el máximo de neuronas.
+Kohonen3D GrowingSom::growMap(const std::vector<Vector>& data, const std::vector<int>& samples, float parent_qe) const {
+    int side = options_.initialSize;
+    LatticeShape lattice{side, side, side, LatticeTopology::Rectangular};
+    int dim = static_cast<int>(data.front().size());
+
+    // prototipos iniciales: muestras repartidas por el conjunto
+    WeightMatrix weights(lattice.neurons(), dim);
+    for (int i = 0; i < lattice.neurons(); i++) {
+        const Vector& x = data[samples[static_cast<std::size_t>(i) * samples.size() / lattice.neurons()]];
+        std::copy(x.begin(), x.end(), weights.row(i));
+    }
+    Kohonen3D net = Kohonen3D::fromCodebook(lattice, std::move(weights));
+
+    // se entrena sobre la vista de las muestras, sin copiarlas
+    SubsetSampleSource source(data, samples);
+    StreamOptions train;
+    train.logEpochs = false;
+    MappingOptions mapping;
+    mapping.threads = options_.threads;
+    double previous_qe = 0.0;
+    for (bool first = true;; first = false) {
+        const LatticeShape& shape = net.getLattice();
+        float radius = 0.5f * std::max({shape.sizeX, shape.sizeY, shape.sizeZ});
+        source.rewind();
+        net.trainStream(source, options_.epochsPerStep, options_.learningRate, radius, train);
+
+        int neurons = net.getNumNeurons();
+        std::vector<double> error(neurons, 0.0);
+        std::vector<int> hits(neurons, 0);
+        for (const MappedSample& m : net.mapBatch(data, samples, mapping)) {
+            error[m.bmu] += m.quantizationError;
+            hits[m.bmu]++;
+        }
+        // error del mapa: media de los errores medios de las neuronas usadas
+        double map_qe = 0.0;
+        int used = 0;
+        for (int i = 0; i < neurons; i++) {
+            if (hits[i] == 0) continue;
+            map_qe += error[i] / hits[i];
+            used++;
+        }
+        map_qe /= std::max(1, used);
+        if (map_qe < options_.breadth * parent_qe) break;
+        if (!first && map_qe > previous_qe * (1.0 - options_.minImprovement)) break;
+        previous_qe = map_qe;
+
+        // la neurona que acumula más error y su vecina (en un eje) más distinta
+        int worst = static_cast<int>(std::max_element(error.begin(), error.end()) - error.begin());
+        int x, y, z;
+        shape.decode(worst, x, y, z);
+        int neighbour = -1;
+        float farthest = -1.0f;
+        const int offsets[6][3] = {{-1, 0, 0}, {1, 0, 0}, {0, -1, 0}, {0, 1, 0}, {0, 0, -1}, {0, 0, 1}};
+        for (const auto& o : offsets) {
+            int nx = x + o[0], ny = y + o[1], nz = z + o[2];
+            if (nx < 0 || nx >= shape.sizeX || ny < 0 || ny >= shape.sizeY || nz < 0 || nz >= shape.sizeZ) continue;
+            int n = shape.index(nx, ny, nz);
+            const float* a = net.getCodebook().row(worst);
+            const float* b = net.getCodebook().row(n);
+            float d2 = 0.0f;
+            for (int j = 0; j < dim; j++) d2 += (a[j] - b[j]) * (a[j] - b[j]);
+            if (d2 > farthest) {
+                farthest = d2;
+                neighbour = n;
+            }
+        }
+
+        int nx, ny, nz;
+        shape.decode(neighbour, nx, ny, nz);
+        int plane = nx != x ? shape.sizeY * shape.sizeZ : (ny != y ? shape.sizeX * shape.sizeZ : shape.sizeX * shape.sizeY);
+        if (neurons + plane > options_.maxNeuronsPerMap) break;
+        net = insertPlane(net, worst, neighbour);
+    }
+    return net;
+}
+
+// Nueva red con un plano más entre a y b (vecinas en un eje); los pesos del
+// plano nuevo son la media de los dos planos que separa.
+Kohonen3D GrowingSom::insertPlane(const Kohonen3D& net, int a, int b) {
+    const LatticeShape& old_shape = net.getLattice();
+    int ac[3], bc[3];
+    old_shape.decode(a, ac[0], ac[1], ac[2]);
+    old_shape.decode(b, bc[0], bc[1], bc[2]);
+    int axis = ac[0] != bc[0] ? 0 : (ac[1] != bc[1] ? 1 : 2);
+    int low = std::min(ac[axis], bc[axis]);
+
+    LatticeShape shape = old_shape;
+    (axis == 0 ? shape.sizeX : axis == 1 ? shape.sizeY : shape.sizeZ)++;
+    int dim = net.getInputDim();
+    WeightMatrix weights(shape.neurons(), dim);
+    for (int i = 0; i < shape.neurons(); i++) {
+        int c[3];
+        shape.decode(i, c[0], c[1], c[2]);
+        float* w = weights.row(i);
+        if (c[axis] == low + 1) {
+            int lo[3] = {c[0], c[1], c[2]}, hi[3] = {c[0], c[1], c[2]};
+            lo[axis] = low;
+            hi[axis] = low + 1;
+            const float* p = net.getCodebook().row(old_shape.index(lo[0], lo[1], lo[2]));
+            const float* q = net.getCodebook().row(old_shape.index(hi[0], hi[1], hi[2]));
+            for (int j = 0; j < dim; j++) w[j] = 0.5f * (p[j] + q[j]);
+        } else {
+            if (c[axis] > low + 1) c[axis]--;
+            const float* p = net.getCodebook().row(old_shape.index(c[0], c[1], c[2]));
+            std::copy(p, p + dim, w);
+        }
+    }
+    return Kohonen3D::fromCodebook(shape, std::move(weights));
+}
+
+HierarchicalBMU GrowingSom::find(const float* x) const {
+    int map = 0;
+    for (;;) {
+        const Node& node = maps_[map];
+        BMUResult r = bmu_.find(node.net.getCodebook(), x);
+        int child = node.children[r.index];
+        if (child < 0) return {map, r.index, node.depth, std::sqrt(r.distance)};
+        map = child;
+    }
+}
+
+std::vector<HierarchicalBMU> GrowingSom::map(const std::vector<Vector>& data, const MappingOptions& options) const {
+    std::vector<HierarchicalBMU> result(data.size());
+    if (data.empty() || maps_.empty()) return result;
+
+    // (mapa, muestras que llegan a él); cada mapa se visita una vez
+    std::vector<std::vector<int>> arriving(maps_.size());
+    arriving[0].resize(data.size());
+    for (std::size_t s = 0; s < data.size(); s++) arriving[0][s] = static_cast<int>(s);
+
+    // los hijos siempre tienen índice mayor que su padre
+    for (int m = 0; m < mapCount(); m++) {
+        const std::vector<int>& samples = arriving[m];
+        if (samples.empty()) continue;
+        std::vector<MappedSample> mapped = maps_[m].net.mapBatch(data, samples, options);
+        for (std::size_t k = 0; k < samples.size(); k++) {
+            int child = maps_[m].children[mapped[k].bmu];
+            if (child >= 0) {
+                arriving[child].push_back(samples[k]);
+            } else {
+                result[samples[k]] = {m, mapped[k].bmu, maps_[m].depth, mapped[k].quantizationError};
+            }
+        }
+        std::vector<int>().swap(arriving[m]);
+    }
+    return result;
+}
+
+int GrowingSom::totalNeurons() const {
+    int total = 0;
+    for (const Node& node : maps_) total += node.net.getNumNeurons();
+    return total;
+}
+
+int GrowingSom::levels() const {
+    int depth = 0;
+    for (const Node& node : maps_) depth = std::max(depth, node.depth + 1);
+    return depth;
+}
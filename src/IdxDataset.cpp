@@ -0,0 +1,106 @@
+#include "IdxDataset.hpp"
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+uint32_t readBigEndian32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+template <typename T, typename Bits>
+T readBigEndian(const uint8_t* p) {
+    Bits bits = 0;
+    for (std::size_t k = 0; k < sizeof(Bits); k++) bits = static_cast<Bits>((bits << 8) | p[k]);
+    T value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+}
+
+std::size_t IdxDataset::elementSizeOf(IdxType type) {
+    switch (type) {
+        case IdxType::UInt8:
+        case IdxType::Int8: return 1;
+        case IdxType::Int16: return 2;
+        case IdxType::Int32:
+        case IdxType::Float32: return 4;
+        case IdxType::Float64: return 8;
+    }
+    throw std::runtime_error("Unknown IDX element type");
+}
+
+IdxDataset::IdxDataset(const std::string& filename)
+    : file_(std::make_shared<MappedFile>(filename)) {
+    const uint8_t* base = file_->data();
+    std::size_t size = file_->size();
+    if (size < 4 || base[0] != 0 || base[1] != 0) {
+        throw std::runtime_error("Invalid IDX magic number in file: " + filename);
+    }
+
+    uint8_t code = base[2];
+    if (code != 0x08 && code != 0x09 && code != 0x0B && code != 0x0C && code != 0x0D && code != 0x0E) {
+        throw std::runtime_error("Unsupported IDX element type in file: " + filename);
+    }
+    type_ = static_cast<IdxType>(code);
+    element_size_ = elementSizeOf(type_);
+
+    int rank = base[3];
+    std::size_t header = 4 + 4 * static_cast<std::size_t>(rank);
+    if (rank == 0 || size < header) throw std::runtime_error("Truncated IDX header in file: " + filename);
+
+    // un producto que desborde podría pasar la comprobación de tamaño y
+    // dejar leer fuera del fichero: se rechazan
+    std::size_t total = 1;
+    for (int d = 0; d < rank; d++) {
+        uint32_t dim = readBigEndian32(base + 4 + 4 * d);
+        if (dim > 0x7fffffffu) throw std::runtime_error("IDX dimension too large in file: " + filename);
+        dims_.push_back(static_cast<int>(dim));
+        if (__builtin_mul_overflow(total, static_cast<std::size_t>(dim), &total) ||
+            (d > 0 && __builtin_mul_overflow(sample_size_, static_cast<int>(dim), &sample_size_))) {
+            throw std::runtime_error("IDX dimensions overflow in file: " + filename);
+        }
+    }
+    std::size_t total_bytes;
+    if (__builtin_mul_overflow(total, element_size_, &total_bytes)) {
+        throw std::runtime_error("IDX dimensions overflow in file: " + filename);
+    }
+    if (size - header < total_bytes) {
+        throw std::runtime_error("IDX file is shorter than its header declares: " + filename);
+    }
+
+    data_ = base + header;
+    file_->adviseSequential();
+}
+
+ByteView IdxDataset::sample(int i) const {
+    if (element_size_ != 1) throw std::runtime_error("IDX sample is not byte-typed");
+    return ByteView(rawSample(i), sample_size_);
+}
+
+void IdxDataset::toFloat(int i, float* out, float scale) const {
+    const uint8_t* p = rawSample(i);
+    int n = sample_size_;
+    switch (type_) {
+        case IdxType::UInt8:
+            for (int j = 0; j < n; j++) out[j] = p[j] * scale;
+            break;
+        case IdxType::Int8:
+            for (int j = 0; j < n; j++) out[j] = static_cast<int8_t>(p[j]) * scale;
+            break;
+        case IdxType::Int16:
+            for (int j = 0; j < n; j++) out[j] = readBigEndian<int16_t, uint16_t>(p + 2 * j) * scale;
+            break;
+        case IdxType::Int32:
+            for (int j = 0; j < n; j++) out[j] = static_cast<float>(readBigEndian<int32_t, uint32_t>(p + 4 * j)) * scale;
+            break;
+        case IdxType::Float32:
+            for (int j = 0; j < n; j++) out[j] = readBigEndian<float, uint32_t>(p + 4 * j) * scale;
+            break;
+        case IdxType::Float64:
+            for (int j = 0; j < n; j++) out[j] = static_cast<float>(readBigEndian<double, uint64_t>(p + 8 * j) * scale);
+            break;
+    }
+}
@@ -1,78 +1,615 @@
 #include "KohonenNetwork.hpp"
+#include "Parallel.hpp"
+#include "PrefetchReader.hpp"
+#include "Profiler.hpp"
+#include "Transport.hpp"
+#include <cfloat>
+#include <climits>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <algorithm>
+#include <stdexcept>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <utility>
 
-Kohonen3D::Kohonen3D(int sizeX, int sizeY, int sizeZ, int input_dim)
-    : sizeX_(sizeX), sizeY_(sizeY), sizeZ_(sizeZ), input_dim_(input_dim) {
-    int total_neurons = sizeX * sizeY * sizeZ;
-    weights_.resize(total_neurons, Vector(input_dim));
-    for (auto& w : weights_) {
-        for (auto& v : w) {
-            v = static_cast<float>(rand()) / RAND_MAX;
+Kohonen3D::Kohonen3D(int sizeX, int sizeY, int sizeZ, int input_dim, LatticeTopology topology)
+    : lattice_{sizeX, sizeY, sizeZ, topology}, input_dim_(input_dim),
+      weights_(sizeX * sizeY * sizeZ, input_dim), metrics_(sizeX * sizeY * sizeZ) {
+    for (int i = 0; i < weights_.rows(); i++) {
+        float* w = weights_.row(i);
+        for (int j = 0; j < input_dim_; j++) {
+            w[j] = static_cast<float>(rand()) / RAND_MAX;
         }
     }
 }
 
-void Kohonen3D::train(const std::vector<Vector>& data, int epochs, float learning_rate_initial, float neighborhood_radius_initial) {
-    int total_neurons = sizeX_ * sizeY_ * sizeZ_;
-    int input_size = input_dim_;
+Kohonen3D::Kohonen3D(const LatticeShape& lattice, int input_dim, WeightMatrix weights)
+    : lattice_(lattice), input_dim_(input_dim), weights_(std::move(weights)), metrics_(lattice.neurons()) {}
+
+Kohonen3D Kohonen3D::fromCodebook(const LatticeShape& lattice, WeightMatrix weights) {
+    if (weights.rows() != lattice.neurons()) throw std::runtime_error("Codebook size does not match the lattice");
+    int input_dim = weights.cols();
+    return Kohonen3D(lattice, input_dim, std::move(weights));
+}
+
+void Kohonen3D::resetSchedule(int epochs, const TrainingSchedule& schedule) {
+    if (epochs <= 0) throw std::runtime_error("The number of epochs must be positive");
+    epoch_ = 0;
+    total_epochs_ = epochs;
+    schedule_ = schedule;
+    schedule_known_ = true;
+    table_ = ScheduleTable();
+}
+
+void Kohonen3D::setSchedule(const TrainingSchedule& schedule) {
+    schedule_ = schedule;
+    schedule_known_ = true;
+    table_ = ScheduleTable();
+}
+
+const TrainingSchedule& Kohonen3D::getSchedule() const {
+    return schedule_;
+}
+
+// Prepara la época epoch_: la tabla sólo se recalcula si cambia el número de
+// épocas o de muestras por época (la primera época o tras setSchedule()).
+void Kohonen3D::beginEpoch(long long samples_per_epoch) {
+    if (!schedule_known_) {
+        throw std::runtime_error("Checkpoint was trained with a custom schedule; call setSchedule() before resuming");
+    }
+    if (!table_.matches(total_epochs_, samples_per_epoch, lattice_)) {
+        table_ = ScheduleTable(schedule_, total_epochs_, samples_per_epoch, lattice_);
+    }
+    metrics_.reset();
+    sample_ = static_cast<long long>(epoch_) * samples_per_epoch;
+    enterStep(table_.stepForEpoch(epoch_));
+}
+
+void Kohonen3D::enterStep(int step) {
+    step_ = step;
+    lr_ = table_.learningRate(step);
+    stencil_ = &table_.stencil(step);
+    bool per_sample = schedule_.granularity == ScheduleGranularity::Sample;
+    next_step_at_ = per_sample && step + 1 < table_.steps() ? table_.stepStart(step + 1) : LLONG_MAX;
+}
 
-    for (int epoch = 0; epoch < epochs; epoch++) {
-        float lr = learning_rate_initial * (1.0f - static_cast<float>(epoch) / epochs);
-        float radius = neighborhood_radius_initial * (1.0f - static_cast<float>(epoch) / epochs);
-
-        for (const auto& input : data) {
-            int winner_idx = 0;
-            float min_dist = euclideanDistanceVec(input, weights_[0]);
-            for (int i = 1; i < total_neurons; i++) {
-                float dist = euclideanDistanceVec(input, weights_[i]);
-                if (dist < min_dist) {
-                    min_dist = dist;
-                    winner_idx = i;
+void Kohonen3D::train(const std::vector<Vector>& data, int epochs, float learning_rate_initial, float neighborhood_radius_initial,
+                      const TrainOptions& options) {
+    train(data, epochs, TrainingSchedule::linear(learning_rate_initial, neighborhood_radius_initial), options);
+}
+
+void Kohonen3D::train(const std::vector<Vector>& data, int epochs, const TrainingSchedule& schedule,
+                      const TrainOptions& options) {
+    resetSchedule(epochs, schedule);
+    runEpochs(data, options);
+}
+
+void Kohonen3D::resume(const std::vector<Vector>& data, const TrainOptions& options) {
+    runEpochs(data, options);
+}
+
+void Kohonen3D::runEpochs(const std::vector<Vector>& data, const TrainOptions& options) {
+    int threads = resolveThreadCount(options.threads);
+
+    std::unique_ptr<ApproxBMUSearch> approx;
+    std::vector<const float*> recall_samples;
+    // Hogwild siempre busca de forma exhaustiva (ver trainHogwildEpoch)
+    if (options.bmuStrategy == BMUStrategy::Approximate && options.mode != TrainMode::Hogwild) {
+        approx.reset(new ApproxBMUSearch(weights_, lattice_, options.approx));
+        int count = std::min<int>(options.approx.recallSamples, static_cast<int>(data.size()));
+        for (int k = 0; k < count; k++) recall_samples.push_back(data[k * data.size() / count].data());
+    }
+
+    for (; epoch_ < total_epochs_; epoch_++) {
+        KOHONEN_PROFILE_SPAN(Epoch);
+        beginEpoch(static_cast<long long>(data.size()));
+        if (approx) {
+            // la pirámide se reconstruye una vez por época y se comprueba su
+            // recall; si no llega al mínimo, esta época usa búsqueda exacta
+            approx->rebuild();
+            RecallReport recall = approx->measureRecall(recall_samples);
+            if (approx->usingExhaustive()) {
+                std::cout << "Approximate BMU recall " << recall.recall << " below threshold, using exhaustive search.\n";
+            }
+        }
+        withTopology(lattice_.topology, [&](auto policy) {
+            using Topology = decltype(policy);
+            if (options.mode == TrainMode::Batch) {
+                trainBatchEpoch<Topology>(data, threads, approx.get());
+            } else if (options.mode == TrainMode::Hogwild) {
+                trainHogwildEpoch<Topology>(data, threads, std::max(1, options.syncInterval));
+            } else {
+                trainOnline<Topology>(data, approx.get());
+            }
+        });
+        if (stopRequested()) return;
+        finishEpoch(options.logEpochs);
+    }
+}
+
+void Kohonen3D::trainStream(SampleSource& source, int epochs, float learning_rate_initial, float neighborhood_radius_initial,
+                            const StreamOptions& options) {
+    trainStream(source, epochs, TrainingSchedule::linear(learning_rate_initial, neighborhood_radius_initial), options);
+}
+
+void Kohonen3D::trainStream(SampleSource& source, int epochs, const TrainingSchedule& schedule,
+                            const StreamOptions& options) {
+    resetSchedule(epochs, schedule);
+    runStreamEpochs(source, options);
+}
+
+void Kohonen3D::resumeStream(SampleSource& source, const StreamOptions& options) {
+    runStreamEpochs(source, options);
+}
+
+void Kohonen3D::runStreamEpochs(SampleSource& source, const StreamOptions& options) {
+    if (source.dim() != input_dim_) throw std::runtime_error("Sample source dimension does not match the network");
+    // con calendario por época el tamaño sólo sirve para numerar muestras
+    long long samples_per_epoch = std::max(0LL, source.sizeHint());
+
+    for (bool first = true; epoch_ < total_epochs_; epoch_++, first = false) {
+        KOHONEN_PROFILE_SPAN(Epoch);
+        beginEpoch(samples_per_epoch);
+
+        // la primera pasada parte de la posición actual (útil para pipes)
+        if (!first) source.rewind();
+        PrefetchReader reader(source, options.chunkRows, options.prefetchDepth);
+        int rows = 0;
+        withTopology(lattice_.topology, [&](auto policy) {
+            using Topology = decltype(policy);
+            for (;;) {
+                const float* chunk;
+                {
+                    KOHONEN_PROFILE_SCOPE(StreamWait);
+                    chunk = reader.next(rows);
+                }
+                if (!chunk || stopRequested()) break;
+                for (int r = 0; r < rows && !stopRequested(); r++) {
+                    trainSample<Topology>(chunk + static_cast<std::size_t>(r) * input_dim_);
                 }
             }
+        });
+        if (stopRequested()) return;
+        finishEpoch(options.logEpochs);
+    }
+}
+
+void Kohonen3D::finishEpoch(bool log) {
+    publishSnapshot();
+    if (log) {
+        std::cout << "Epoch " << epoch_ + 1 << "/" << total_epochs_ << " done. QE " << metrics_.quantizationError();
+        if (metrics_.topographicError() >= 0.0) std::cout << ", TE " << metrics_.topographicError();
+        std::cout << "\n";
+    }
+    if (observer_) observer_->onEpochEnd(epoch_, metrics_);
+}
+
+template <typename Topology>
+void Kohonen3D::trainOnline(const std::vector<Vector>& data, const ApproxBMUSearch* approx) {
+    int hint = -1;
+    // con búsqueda aproximada la actualización puntúa ya la muestra
+    // siguiente contra las filas que acaba de escribir
+    bool fuse = approx && approx->usesHint();
+    for (std::size_t s = 0; s < data.size() && !stopRequested(); s++) {
+        const float* next = fuse && s + 1 < data.size() ? data[s + 1].data() : nullptr;
+        hint = trainSample<Topology>(data[s].data(), approx, hint, next);
+    }
+}
+
+BMUResult Kohonen3D::findWinner(const float* x_in, const ApproxBMUSearch* approx, int hint) const {
+    return approx ? approx->find(x_in, hint) : bmu_.find(weights_, x_in);
+}
+
+// El error topográfico cuenta como vecinas las de la topología de la red.
+template <typename Topology>
+void Kohonen3D::recordMetrics(const BMUResult& winner) {
+    bool second_known = winner.second >= 0;
+    metrics_.add(winner.index, winner.distance, second_known,
+                 second_known && Topology::adjacent(lattice_, winner.index, winner.second));
+    if (observer_ && progress_interval_ > 0 && metrics_.samples() % progress_interval_ == 0) {
+        observer_->onProgress(epoch_, metrics_);
+    }
+}
+
+template <typename Topology>
+int Kohonen3D::trainSample(const float* x_in, const ApproxBMUSearch* approx, int hint, const float* next) {
+    BMUResult winner;
+    {
+        KOHONEN_PROFILE_SCOPE(BMUSearch);
+        winner = findWinner(x_in, approx, hint);
+    }
+    recordMetrics<Topology>(winner);
+    int winner_idx = winner.index;
+
+    int wx, wy, wz;
+    lattice_.decode(winner_idx, wx, wy, wz);
+
+    // 1) vecinas de la ganadora y su tasa lr * h
+    float lr = lr_;
+    updates_.clear();
+    {
+        KOHONEN_PROFILE_SCOPE(Neighborhood);
+        stencil_->forEach<Topology>(wx, wy, wz, lattice_.sizeX, lattice_.sizeY, lattice_.sizeZ, [&](int i, float h) {
+            updates_.push_back({i, lr * h});
+        });
+    }
+
+    // 2) w += alpha (x - w) en cada una
+    int next_hint = winner_idx;
+    {
+        KOHONEN_PROFILE_SCOPE(WeightUpdate);
+        int count = static_cast<int>(updates_.size());
+        if (next) {
+            BMUResult nearest = update_.applyAndScore(weights_, x_in, updates_.data(), count, next);
+            if (nearest.index >= 0) next_hint = nearest.index;
+        } else {
+            update_.apply(weights_, x_in, updates_.data(), count);
+        }
+        if (snapshot_) {
+            for (const NeighborUpdate& u : updates_) snapshot_->markDirty(u.neuron);
+        }
+    }
+    // la búsqueda exhaustiva lee el codebook entero; cada vecina se lee y escribe
+    KOHONEN_PROFILE_COUNT(1, updates_.size(),
+                          (approx ? 0 : weights_.sizeBytes()) + updates_.size() * 2 * weights_.stride() * sizeof(float));
+    if (snapshot_ && ++samples_since_snapshot_ >= snapshot_interval_) publishSnapshot();
+    // el calendario por muestra avanza leyendo la tabla, sin recalcular nada
+    if (++sample_ >= next_step_at_) enterStep(step_ + 1);
+    return next_hint;
+}
+
+void Kohonen3D::setSnapshot(WeightSnapshot* snapshot, int every_samples) {
+    snapshot_ = snapshot;
+    snapshot_interval_ = std::max(1, every_samples);
+    samples_since_snapshot_ = 0;
+}
+
+void Kohonen3D::setObserver(TrainingObserver* observer, int every_samples) {
+    observer_ = observer;
+    progress_interval_ = std::max(0, every_samples);
+}
+
+void Kohonen3D::setStopFlag(const std::atomic<bool>* stop) {
+    stop_ = stop;
+}
+
+const TrainingMetrics& Kohonen3D::getMetrics() const {
+    return metrics_;
+}
+
+void Kohonen3D::publishSnapshot() {
+    if (!snapshot_) return;
+    samples_since_snapshot_ = 0;
+    snapshot_->publish(weights_);
+}
+
+namespace {
+
+// Un cerrojo de giro por fila del codebook compartido de Hogwild. Cada
+// escritura toca una sola fila y dura lo que una actualización, así que
+// casi nunca hay espera; al ceder el procesador, un hilo que encuentra la
+// fila ocupada no frena al que la tiene cuando hay más hilos que núcleos.
+class RowLocks {
+public:
+    explicit RowLocks(int rows) : locks_(rows) {}
+
+    void lock(int row) {
+        while (locks_[row].exchange(true, std::memory_order_acquire)) {
+            while (locks_[row].load(std::memory_order_relaxed)) std::this_thread::yield();
+        }
+    }
+    void unlock(int row) { locks_[row].store(false, std::memory_order_release); }
 
-            int wx = winner_idx / (sizeY_ * sizeZ_);
-            int wy = (winner_idx / sizeZ_) % sizeY_;
-            int wz = winner_idx % sizeZ_;
+private:
+    std::vector<std::atomic<bool>> locks_;
+};
 
-            for (int i = 0; i < total_neurons; i++) {
-                int x = i / (sizeY_ * sizeZ_);
-                int y = (i / sizeZ_) % sizeY_;
-                int z = i % sizeZ_;
+}  // namespace
 
-                float dist_to_winner = euclideanDistance3D(x, y, z, wx, wy, wz);
-                if (dist_to_winner <= radius) {
-                    float h = std::exp(-(dist_to_winner * dist_to_winner) / (2 * radius * radius));
-                    for (int j = 0; j < input_size; j++) {
-                        weights_[i][j] += lr * h * (input[j] - weights_[i][j]);
+// Online en paralelo (Hogwild): el hilo t recorre en orden el tramo t de las
+// muestras. Busca la BMU con BMUSearch en su propia copia del codebook, que
+// se refresca entera en cada sincronización, y escribe el vecindario con
+// UpdateKernel directamente en las filas compartidas, cada una bajo su
+// cerrojo; después copia la fila resultante a su copia, de modo que ve sus
+// propias actualizaciones y las de los demás en las filas que toca. Entre
+// sincronizaciones las BMUs se calculan con un codebook algo desfasado: con
+// codebooks grandes y radios pequeños la regla se parece mucho a la
+// secuencial, y con un hilo es exactamente la secuencial.
+//
+// Los hilos duran toda la época y se esperan en una barrera cada
+// sync_interval muestras. Entre esa espera y la siguiente nadie escribe en
+// el codebook: cada hilo refresca su copia y el hilo llamante combina las
+// métricas, avanza el calendario (lr_ y stencil_, que los demás leen sin
+// copiar) y publica el snapshot.
+template <typename Topology>
+void Kohonen3D::trainHogwildEpoch(const std::vector<Vector>& data, int threads, int sync_interval) {
+    int num_samples = static_cast<int>(data.size());
+    int shards = std::max(1, std::min(threads, num_samples));
+    struct Worker {
+        int begin, end;   // tramo de muestras
+        TrainingMetrics metrics;
+        std::vector<NeighborUpdate> updates;
+        WeightMatrix local;   // codebook de la última sincronización + filas tocadas desde entonces
+    };
+    std::vector<Worker> workers;
+    for (int t = 0; t < shards; t++) {
+        int begin = static_cast<int>(static_cast<long long>(num_samples) * t / shards);
+        int end = static_cast<int>(static_cast<long long>(num_samples) * (t + 1) / shards);
+        workers.push_back({begin, end, TrainingMetrics(lattice_.neurons()), {}, weights_});
+    }
+    int longest = workers.front().end - workers.front().begin;
+    for (const Worker& w : workers) longest = std::max(longest, w.end - w.begin);
+    if (longest == 0) return;
+
+    RowLocks locks(weights_.rows());
+    std::size_t row_bytes = static_cast<std::size_t>(weights_.stride()) * sizeof(float);
+    Barrier barrier(shards);
+    bool done = false;   // lo escribe el hilo llamante entre las dos esperas
+    auto run = [&](int t) {
+        Worker& worker = workers[t];
+        for (int offset = 0; !done; offset += sync_interval) {
+            int first = std::min(worker.end, worker.begin + offset);
+            int last = std::min(worker.end, first + sync_interval);
+            for (int s = first; s < last; s++) {
+                const float* x_in = data[s].data();
+                BMUResult winner;
+                {
+                    KOHONEN_PROFILE_SCOPE(BMUSearch);
+                    winner = bmu_.find(worker.local, x_in);
+                }
+                bool second_known = winner.second >= 0;
+                worker.metrics.add(winner.index, winner.distance, second_known,
+                                   second_known && Topology::adjacent(lattice_, winner.index, winner.second));
+
+                int wx, wy, wz;
+                lattice_.decode(winner.index, wx, wy, wz);
+                worker.updates.clear();
+                {
+                    KOHONEN_PROFILE_SCOPE(Neighborhood);
+                    stencil_->forEach<Topology>(wx, wy, wz, lattice_.sizeX, lattice_.sizeY, lattice_.sizeZ,
+                                                [&](int i, float h) { worker.updates.push_back({i, lr_ * h}); });
+                }
+                {
+                    KOHONEN_PROFILE_SCOPE(WeightUpdate);
+                    for (const NeighborUpdate& u : worker.updates) {
+                        locks.lock(u.neuron);
+                        update_.apply(weights_, x_in, &u, 1);
+                        std::memcpy(worker.local.row(u.neuron), weights_.row(u.neuron), row_bytes);
+                        locks.unlock(u.neuron);
                     }
                 }
+                // cada vecina se lee, se escribe y se copia a la copia local
+                KOHONEN_PROFILE_COUNT(1, worker.updates.size(),
+                                      weights_.sizeBytes() + worker.updates.size() * 3 * row_bytes);
             }
+
+            barrier.wait();
+            if (t == 0) {
+                // punto de sincronización
+                long long round_samples = 0;
+                for (Worker& w : workers) {
+                    round_samples += w.metrics.samples();
+                    metrics_.merge(w.metrics);
+                    w.metrics.reset();
+                }
+                if (observer_ && progress_interval_ > 0 &&
+                    metrics_.samples() / progress_interval_ != (metrics_.samples() - round_samples) / progress_interval_) {
+                    observer_->onProgress(epoch_, metrics_);
+                }
+                sample_ += round_samples;
+                while (sample_ >= next_step_at_) enterStep(step_ + 1);
+                if (snapshot_) {
+                    snapshot_->markAllDirty();
+                    samples_since_snapshot_ += static_cast<int>(round_samples);
+                    if (samples_since_snapshot_ >= snapshot_interval_) publishSnapshot();
+                }
+                done = offset + sync_interval >= longest || stopRequested();
+            }
+            std::memcpy(worker.local.data(), weights_.data(), weights_.sizeBytes());
+            barrier.wait();
         }
-        std::cout << "Epoch " << epoch + 1 << "/" << epochs << " done.\n";
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(shards - 1);
+    for (int t = 1; t < shards; t++) pool.emplace_back(run, t);
+    run(0);
+    for (std::thread& thread : pool) thread.join();
+}
+
+// Batch SOM: w_i = sum_s h(i, bmu(s)) x_s / sum_s h(i, bmu(s)).
+// Se agrupan las muestras por BMU (sumas de Voronoi) y después cada neurona
+// combina las sumas de sus vecinas. Cada acumulador lo calcula un único hilo
+// y siempre en el mismo orden de muestras, así que el resultado no depende
+// del número de hilos. El vecindario es el del inicio de la época también
+// con calendario por muestra: en batch no hay actualizaciones intermedias.
+template <typename Topology>
+void Kohonen3D::trainBatchEpoch(const std::vector<Vector>& data, int threads, const ApproxBMUSearch* approx) {
+    int total_neurons = weights_.rows();
+    int num_samples = static_cast<int>(data.size());
+    WeightMatrix sums(total_neurons, input_dim_);
+    std::vector<float> hits(total_neurons, 0.0f);
+    accumulateVoronoi<Topology>(data, threads, approx, sums, hits);
+    smoothCodebook<Topology>(sums, hits, threads);
+    // codebook leído en la búsqueda, muestras y sumas leídas, codebook escrito
+    KOHONEN_PROFILE_COUNT(num_samples, total_neurons,
+                          (approx ? 0 : static_cast<std::size_t>(num_samples) * weights_.sizeBytes()) +
+                              static_cast<std::size_t>(num_samples) * input_dim_ * sizeof(float) +
+                              2 * weights_.sizeBytes());
+    if (snapshot_) snapshot_->markAllDirty();
+}
+
+// Pasos 1-3 del batch: BMUs con el codebook actual, métricas, y suma de las
+// muestras (sums) y número de muestras (hits) por neurona.
+template <typename Topology>
+void Kohonen3D::accumulateVoronoi(const std::vector<Vector>& data, int threads, const ApproxBMUSearch* approx,
+                                  WeightMatrix& sums, std::vector<float>& hits) {
+    int total_neurons = weights_.rows();
+    int num_samples = static_cast<int>(data.size());
+    int input_size = input_dim_;
+
+    // 1) BMU de cada muestra con el codebook de la época anterior (sin
+    // arranque en caliente, que haría depender el resultado del reparto)
+    std::vector<BMUResult> winners(num_samples);
+    parallelFor(0, num_samples, threads, [&](int begin, int end, int) {
+        KOHONEN_PROFILE_SPAN(BMUSearch);
+        for (int s = begin; s < end; s++) {
+            winners[s] = findWinner(data[s].data(), approx, -1);
+        }
+    });
+    for (const BMUResult& w : winners) recordMetrics<Topology>(w);
+
+    // 2) ordenar las muestras por BMU conservando su orden original
+    std::vector<int> offsets(total_neurons + 1, 0);
+    for (const BMUResult& w : winners) offsets[w.index + 1]++;
+    for (int i = 0; i < total_neurons; i++) offsets[i + 1] += offsets[i];
+    std::vector<int> order(num_samples);
+    {
+        std::vector<int> cursor(offsets.begin(), offsets.end() - 1);
+        for (int s = 0; s < num_samples; s++) order[cursor[winners[s].index]++] = s;
     }
+
+    // 3) sumas de Voronoi por neurona
+    parallelFor(0, total_neurons, threads, [&](int begin, int end, int) {
+        KOHONEN_PROFILE_SPAN(BatchAccumulate);
+        for (int i = begin; i < end; i++) {
+            float* acc = sums.row(i);
+            for (int k = offsets[i]; k < offsets[i + 1]; k++) {
+                const float* x_in = data[order[k]].data();
+                for (int j = 0; j < input_size; j++) acc[j] += x_in[j];
+            }
+            hits[i] = static_cast<float>(offsets[i + 1] - offsets[i]);
+        }
+    });
 }
 
-const std::vector<Vector>& Kohonen3D::getWeights() const {
-    return weights_;
+// Paso 4 del batch: suavizado de las sumas con el vecindario y nuevo codebook.
+template <typename Topology>
+void Kohonen3D::smoothCodebook(const WeightMatrix& sums, const std::vector<float>& hits, int threads) {
+    int total_neurons = weights_.rows();
+    int input_size = input_dim_;
+    parallelFor(0, total_neurons, threads, [&](int begin, int end, int) {
+        KOHONEN_PROFILE_SPAN(WeightUpdate);
+        std::vector<float> numerator(input_size);
+        for (int i = begin; i < end; i++) {
+            int x, y, z;
+            lattice_.decode(i, x, y, z);
+
+            std::fill(numerator.begin(), numerator.end(), 0.0f);
+            float denominator = 0.0f;
+            stencil_->forEach<Topology>(x, y, z, lattice_.sizeX, lattice_.sizeY, lattice_.sizeZ, [&](int n, float h) {
+                if (hits[n] == 0.0f) return;
+                const float* acc = sums.row(n);
+                for (int j = 0; j < input_size; j++) numerator[j] += h * acc[j];
+                denominator += h * hits[n];
+            });
+
+            if (denominator > 0.0f) {
+                float* w = weights_.row(i);
+                float inv = 1.0f / denominator;
+                for (int j = 0; j < input_size; j++) w[j] = numerator[j] * inv;
+            }
+        }
+    });
+}
+
+void Kohonen3D::trainDistributed(const std::vector<Vector>& shard, int epochs, float learning_rate_initial,
+                                 float neighborhood_radius_initial, Transport& transport,
+                                 const DistributedOptions& options) {
+    trainDistributed(shard, epochs, TrainingSchedule::linear(learning_rate_initial, neighborhood_radius_initial),
+                     transport, options);
 }
 
-int Kohonen3D::getSizeX() const { return sizeX_; }
-int Kohonen3D::getSizeY() const { return sizeY_; }
-int Kohonen3D::getSizeZ() const { return sizeZ_; }
+// Batch SOM repartido: cada proceso acumula las sumas de Voronoi de su parte
+// de las muestras, se suman en anillo y todos aplican el mismo suavizado
+// sobre los mismos bits, así que los codebooks nunca divergen y no hace falta
+// volver a repartirlos.
+void Kohonen3D::trainDistributed(const std::vector<Vector>& shard, int epochs, const TrainingSchedule& schedule,
+                                 Transport& transport, const DistributedOptions& options) {
+    for (const Vector& x : shard) {
+        if (static_cast<int>(x.size()) != input_dim_) throw std::runtime_error("Sample dimension does not match the network");
+    }
+    resetSchedule(epochs, schedule);
+    int threads = resolveThreadCount(options.threads);
+    bool coordinator = transport.rank() == 0;
+
+    // antes de mover el codebook, comprobar que todos tienen la misma red:
+    // con otro tamaño el broadcast y los allreduce desalinearían los mensajes
+    int32_t config[] = {lattice_.sizeX, lattice_.sizeY, lattice_.sizeZ, static_cast<int32_t>(lattice_.topology),
+                        input_dim_, total_epochs_};
+    int32_t expected[std::size(config)];
+    std::copy(std::begin(config), std::end(config), expected);
+    broadcast(transport, expected, sizeof(expected));
+    double mismatches = std::equal(std::begin(config), std::end(config), expected) ? 0.0 : 1.0;
+    ringAllreduce(transport, &mismatches, 1);
+    if (mismatches > 0.0) {
+        throw std::runtime_error("Distributed ranks disagree on the lattice, input dimension or epochs (" +
+                                 std::to_string(static_cast<int>(mismatches)) + " of " +
+                                 std::to_string(transport.size()) + " ranks differ from rank 0)");
+    }
+
+    // todos parten del codebook del coordinador
+    broadcast(transport, weights_.data(), weights_.sizeBytes());
+    double total_samples = static_cast<double>(shard.size());
+    ringAllreduce(transport, &total_samples, 1);
 
-float Kohonen3D::euclideanDistanceVec(const Vector& a, const Vector& b) {
-    float dist = 0.0f;
-    for (size_t i = 0; i < a.size(); i++) {
-        float diff = a[i] - b[i];
-        dist += diff * diff;
+    int total_neurons = weights_.rows();
+    std::vector<double> counts(total_neurons);
+    for (; epoch_ < total_epochs_; epoch_++) {
+        KOHONEN_PROFILE_SPAN(Epoch);
+        beginEpoch(static_cast<long long>(total_samples));
+        WeightMatrix sums(total_neurons, input_dim_);
+        std::vector<float> hits(total_neurons, 0.0f);
+        withTopology(lattice_.topology, [&](auto policy) {
+            using Topology = decltype(policy);
+            accumulateVoronoi<Topology>(shard, threads, nullptr, sums, hits);
+            // el relleno de las filas es cero en todos y se suma como tal;
+            // los hits en double para que sigan siendo exactos
+            ringAllreduce(transport, sums.data(), static_cast<std::size_t>(total_neurons) * sums.stride());
+            std::copy(hits.begin(), hits.end(), counts.begin());
+            ringAllreduce(transport, counts.data(), counts.size());
+            std::copy(counts.begin(), counts.end(), hits.begin());
+            smoothCodebook<Topology>(sums, hits, threads);
+        });
+
+        std::vector<double> metrics = metrics_.pack();
+        ringAllreduce(transport, metrics.data(), metrics.size());
+        metrics_.unpack(metrics);
+        if (snapshot_) snapshot_->markAllDirty();
+        finishEpoch(options.logEpochs && coordinator);
     }
-    return std::sqrt(dist);
 }
 
-float Kohonen3D::euclideanDistance3D(int x1, int y1, int z1, int x2, int y2, int z2) {
-    return std::sqrt((x1 - x2)*(x1 - x2) +
-                     (y1 - y2)*(y1 - y2) +
-                     (z1 - z2)*(z1 - z2));
+std::vector<MappedSample> Kohonen3D::mapBatch(const std::vector<Vector>& data, const MappingOptions& options) const {
+    return BatchMapper(weights_).map(data, options);
+}
+
+std::vector<MappedSample> Kohonen3D::mapBatch(const std::vector<Vector>& data, const std::vector<int>& indices,
+                                              const MappingOptions& options) const {
+    return BatchMapper(weights_).map(data, indices, options);
 }
+
+std::vector<MappedSample> Kohonen3D::mapBatch(SampleSource& source, const MappingOptions& options) const {
+    return BatchMapper(weights_).map(source, options);
+}
+
+const WeightMatrix& Kohonen3D::getCodebook() const {
+    return weights_;
+}
+
+RowView Kohonen3D::getWeight(int neuron) const {
+    return weights_.rowView(neuron);
+}
+
+int Kohonen3D::getNumNeurons() const { return weights_.rows(); }
+int Kohonen3D::getInputDim() const { return input_dim_; }
+int Kohonen3D::getSizeX() const { return lattice_.sizeX; }
+int Kohonen3D::getSizeY() const { return lattice_.sizeY; }
+int Kohonen3D::getSizeZ() const { return lattice_.sizeZ; }
+LatticeTopology Kohonen3D::getTopology() const { return lattice_.topology; }
+const LatticeShape& Kohonen3D::getLattice() const { return lattice_; }
+int Kohonen3D::getEpoch() const { return epoch_; }
+int Kohonen3D::getTotalEpochs() const { return total_epochs_; }
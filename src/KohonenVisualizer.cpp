@@ -1,5 +1,39 @@
+// glGenBuffers y compañía (OpenGL 1.5) sólo se declaran con esta macro.
+#define GL_GLEXT_PROTOTYPES
 #include "KohonenVisualizer.hpp"
+#include "CameraPath.hpp"
+#include "PrototypeImage.hpp"
 #include <SOIL/SOIL.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace {
+
+const float kFovY = 45.0f;
+const float kQuadHalfSize = 0.8f;
+const int kCellSide = 8;          // neuronas por lado de cada bloque de culling
+const int kAtlasPadding = 2;      // MNIST: 28 + 2*2 = 32, teselas alineadas en todos los mipmaps
+const int kMaxMipLevel = 3;       // 4x4 texels por tesela en el último nivel
+const float kLodPixels = 6.0f;    // por debajo de este tamaño en pantalla, un punto
+const std::chrono::seconds kRefitInterval(2);  // reajuste de barras / PCA durante el entrenamiento
+
+// Distancia focal en píxeles: un objeto de tamaño s a distancia d ocupa
+// s * focalPixels / d píxeles de alto.
+float focalPixels(int viewport_height) {
+    return viewport_height * 0.5f / std::tan(kFovY * 0.5f * 3.14159265f / 180.0f);
+}
+
+float distanceToBox(const float* p, const float* lo, const float* hi) {
+    float sum = 0.0f;
+    for (int k = 0; k < 3; ++k) {
+        float d = std::max({lo[k] - p[k], 0.0f, p[k] - hi[k]});
+        sum += d * d;
+    }
+    return std::sqrt(sum);
+}
+
+}
 
 KohonenVisualizer::KohonenVisualizer(Kohonen3D* net) : kohonenNet(net) {}
 
@@ -7,85 +41,317 @@ void KohonenVisualizer::initGL() {
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_TEXTURE_2D);
     glClearColor(0.2f, 0.2f, 0.3f, 1.0f);
+
+    // tamaño de los puntos del LOD lejano proporcional a 1/distancia
+    const GLfloat attenuation[3] = {0.0f, 0.0f, 1.0f};
+    glPointParameterfv(GL_POINT_DISTANCE_ATTENUATION, attenuation);
+    glPointParameterf(GL_POINT_SIZE_MIN, 1.0f);
+}
+
+void KohonenVisualizer::setSampleShape(const SampleShape& shape) {
+    sampleShape = shape;
+}
+
+void KohonenVisualizer::initNeurons() {
+    if (!kohonenNet) return;
+
+    if (sampleShape.empty()) sampleShape = SampleShape::guess(kohonenNet->getInputDim());
+    prototypeRenderer = makePrototypeRenderer(sampleShape, kohonenNet->getCodebook());
+    lastRefit = std::chrono::steady_clock::now();
+
+    // posiciones según la topología (la BCC desplaza las capas impares),
+    // separadas 2 unidades y centradas en el origen
+    const LatticeShape& lattice = kohonenNet->getLattice();
+    neurons.resize(lattice.neurons());
+    float lo[3] = {FLT_MAX, FLT_MAX, FLT_MAX}, hi[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (int i = 0; i < lattice.neurons(); ++i) {
+        float p[3];
+        lattice.position(i, p);
+        neurons[i] = {p[0] * 2.0f, p[1] * 2.0f, p[2] * 2.0f};
+        for (int k = 0; k < 3; ++k) {
+            lo[k] = std::min(lo[k], p[k] * 2.0f);
+            hi[k] = std::max(hi[k], p[k] * 2.0f);
+        }
+    }
+    for (Neuron& n : neurons) {
+        n.x -= 0.5f * (lo[0] + hi[0]);
+        n.y -= 0.5f * (lo[1] + hi[1]);
+        n.z -= 0.5f * (lo[2] + hi[2]);
+    }
+    grid = LatticeGrid(lattice.sizeX, lattice.sizeY, lattice.sizeZ, kCellSide);
+
+    // caja de cada bloque a partir de las posiciones reales de sus neuronas
+    cellBounds.clear();
+    for (const GridCell& cell : grid.cells()) {
+        float box[6] = {FLT_MAX, FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX};
+        for (int p = cell.first; p < cell.first + cell.count; ++p) {
+            const Neuron& n = neurons[grid.order()[p]];
+            const float xyz[3] = {n.x, n.y, n.z};
+            for (int k = 0; k < 3; ++k) {
+                box[k] = std::min(box[k], xyz[k] - kQuadHalfSize);
+                box[k + 3] = std::max(box[k + 3], xyz[k] + kQuadHalfSize);
+            }
+        }
+        cellBounds.insert(cellBounds.end(), box, box + 6);
+    }
+
+    buildAtlas();
+    buildVertexBuffers();
 }
 
-GLuint KohonenVisualizer::createTextureFromMNIST(const std::vector<float>& image, int width, int height) {
-    std::vector<unsigned char> pixels(width * height * 3);
-    for (int i = 0; i < width * height; ++i) {
-        unsigned char val = static_cast<unsigned char>(image[i] * 255);
-        pixels[i*3 + 0] = val;
-        pixels[i*3 + 1] = val;
-        pixels[i*3 + 2] = val;
+// Todos los prototipos van a un atlas (una página salvo en redes muy
+// grandes) en el orden de la rejilla de culling, de modo que cada bloque de
+// neuronas es un rango contiguo tanto en el atlas como en los VBO.
+void KohonenVisualizer::buildAtlas() {
+    GLint max_size = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+    atlas = TextureAtlas(prototypeRenderer->width(), prototypeRenderer->height(),
+                         static_cast<int>(neurons.size()), max_size, kAtlasPadding);
+
+    tilePixels.resize(atlas.tileWidth() * atlas.tileHeight() * 3);
+    points.resize(neurons.size());
+    for (int p = 0; p < atlas.tileCount(); ++p) {
+        setPrototype(p, kohonenNet->getWeight(grid.order()[p]));
     }
 
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
+    for (const auto& page : pages) glDeleteTextures(1, &page.textureID);
+    pages.clear();
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int p = 0; p < atlas.pageCount(); ++p) {
+        AtlasPage page;
+        glGenTextures(1, &page.textureID);
+        glBindTexture(GL_TEXTURE_2D, page.textureID);
+        // los mipmaps se regeneran solos también con glTexSubImage2D
+        glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, kMaxMipLevel);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, atlas.pageWidth(), atlas.pageHeight(), 0,
+                     GL_RGB, GL_UNSIGNED_BYTE, atlas.pageData(p));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-    return textureID;
+        page.begin = p * atlas.tilesPerPage();
+        page.end = std::min(page.begin + atlas.tilesPerPage(), atlas.tileCount());
+        pages.push_back(page);
+    }
 }
 
-void KohonenVisualizer::initNeurons() {
-    if (!kohonenNet) return;
+// Tesela del atlas (en memoria) y color medio del punto de LOD.
+void KohonenVisualizer::setPrototype(int position, RowView prototype) {
+    prototypeRenderer->render(prototype, tilePixels.data());
+    atlas.setTile(position, tilePixels.data());
 
-    const auto& weights = kohonenNet->getWeights();
-    int sizeX = kohonenNet->getSizeX();
-    int sizeY = kohonenNet->getSizeY();
-    int sizeZ = kohonenNet->getSizeZ();
-
-    for (int x = 0; x < sizeX; ++x) {
-        for (int y = 0; y < sizeY; ++y) {
-            for (int z = 0; z < sizeZ; ++z) {
-                int idx = x * sizeY * sizeZ + y * sizeZ + z;
-                Neuron n;
-                n.x = x * 2.0f;
-                n.y = y * 2.0f;
-                n.z = z * 2.0f;
-                n.textureID = createTextureFromMNIST(weights[idx], 28, 28);
-                neurons.push_back(n);
-            }
+    unsigned sum[3] = {0, 0, 0};
+    for (std::size_t k = 0; k < tilePixels.size(); k += 3) {
+        for (int c = 0; c < 3; ++c) sum[c] += tilePixels[k + c];
+    }
+    unsigned texels = static_cast<unsigned>(tilePixels.size() / 3);
+    PointVertex& point = points[position];
+    point.r = static_cast<unsigned char>(sum[0] / texels);
+    point.g = static_cast<unsigned char>(sum[1] / texels);
+    point.b = static_cast<unsigned char>(sum[2] / texels);
+    point.a = 255;
+}
+
+void KohonenVisualizer::setSnapshotSource(WeightSnapshot* source) {
+    snapshot = source;
+}
+
+// Sólo se tocan las teselas de las neuronas cambiadas, con glTexSubImage2D
+// sobre la página existente (tesela + margen, directamente desde la copia
+// del atlas en memoria), y sus puntos de LOD.
+bool KohonenVisualizer::updateFromSnapshot() {
+    if (!snapshot || pages.empty()) return false;
+    const WeightMatrix* weights = snapshot->acquire(changedNeurons);
+    if (!weights) return false;
+
+    // la instantánea es el codebook completo: vale para reajustar
+    if (!sampleShape.isImage() && std::chrono::steady_clock::now() - lastRefit >= kRefitInterval) {
+        refitRenderer(*weights);
+        snapshot->release();
+        return true;
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, atlas.pageWidth());
+    glBindBuffer(GL_ARRAY_BUFFER, pointBuffer);
+    int bound = -1;
+    for (int i : changedNeurons) {
+        int position = grid.position(i);
+        setPrototype(position, weights->rowView(i));
+
+        const AtlasTile& t = atlas.tile(position);
+        if (t.page != bound) {
+            glBindTexture(GL_TEXTURE_2D, pages[t.page].textureID);
+            bound = t.page;
         }
+        int x0 = t.x - atlas.padding();
+        int y0 = t.y - atlas.padding();
+        glPixelStorei(GL_UNPACK_SKIP_PIXELS, x0);
+        glPixelStorei(GL_UNPACK_SKIP_ROWS, y0);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x0, y0, atlas.slotWidth(), atlas.slotHeight(),
+                        GL_RGB, GL_UNSIGNED_BYTE, atlas.pageData(t.page));
+        glBufferSubData(GL_ARRAY_BUFFER, position * sizeof(PointVertex), 4, &points[position]);
     }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+    snapshot->release();
+    return !changedNeurons.empty();
 }
 
-void KohonenVisualizer::drawTexturedQuad(float x, float y, float z, GLuint textureID) {
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, textureID);
+void KohonenVisualizer::refitPrototypes() {
+    if (!kohonenNet || pages.empty() || sampleShape.isImage()) return;
+    refitRenderer(kohonenNet->getCodebook());
+}
+
+// Las teselas de imagen no dependen del codebook; las demás se vuelven a
+// dibujar todas con la escala nueva y se suben las páginas enteras.
+void KohonenVisualizer::refitRenderer(const WeightMatrix& codebook) {
+    prototypeRenderer = makePrototypeRenderer(sampleShape, codebook);
+    lastRefit = std::chrono::steady_clock::now();
+    for (int p = 0; p < atlas.tileCount(); ++p) {
+        setPrototype(p, codebook.rowView(grid.order()[p]));
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int p = 0; p < atlas.pageCount(); ++p) {
+        glBindTexture(GL_TEXTURE_2D, pages[p].textureID);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, atlas.pageWidth(), atlas.pageHeight(),
+                        GL_RGB, GL_UNSIGNED_BYTE, atlas.pageData(p));
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, pointBuffer);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, points.size() * sizeof(PointVertex), points.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Los quads de todas las neuronas se expanden una vez en un VBO estático, y
+// sus puntos de LOD en otro, ambos en el orden de la rejilla. La red no se
+// mueve, así que no hace falta instanciado (ni shaders): cada fotograma
+// dibuja los rangos visibles con glMultiDrawArrays.
+void KohonenVisualizer::buildVertexBuffers() {
+    std::vector<Vertex> vertices;
+    vertices.reserve(neurons.size() * 4);
+    for (int p = 0; p < static_cast<int>(neurons.size()); ++p) {
+        const Neuron& n = neurons[grid.order()[p]];
+        const AtlasTile& t = atlas.tile(p);
+        vertices.push_back({t.u0, t.v0, n.x - kQuadHalfSize, n.y - kQuadHalfSize, n.z});
+        vertices.push_back({t.u1, t.v0, n.x + kQuadHalfSize, n.y - kQuadHalfSize, n.z});
+        vertices.push_back({t.u1, t.v1, n.x + kQuadHalfSize, n.y + kQuadHalfSize, n.z});
+        vertices.push_back({t.u0, t.v1, n.x - kQuadHalfSize, n.y + kQuadHalfSize, n.z});
+        points[p].x = n.x;
+        points[p].y = n.y;
+        points[p].z = n.z;
+    }
+
+    if (!vertexBuffer) glGenBuffers(1, &vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+
+    if (!pointBuffer) glGenBuffers(1, &pointBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, pointBuffer);
+    glBufferData(GL_ARRAY_BUFFER, points.size() * sizeof(PointVertex), points.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// El plano lejano se aleja lo necesario para que quepa toda la red.
+void KohonenVisualizer::applyProjection() {
+    float far_plane = kohonenNet
+        ? cameraFarPlane(zoom, kohonenNet->getSizeX(), kohonenNet->getSizeY(), kohonenNet->getSizeZ())
+        : cameraFarPlane(zoom, 0, 0, 0);
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    gluPerspective(kFovY, float(viewportWidth) / viewportHeight, kCameraNear, far_plane);
+    glMatrixMode(GL_MODELVIEW);
+}
 
-    glPushMatrix();
-    glTranslatef(x, y, z);
-    glBegin(GL_QUADS);
-    glColor3f(1, 1, 1);
-    glTexCoord2f(0, 0); glVertex3f(-0.8, -0.8, 0.0);
-    glTexCoord2f(1, 0); glVertex3f( 0.8, -0.8, 0.0);
-    glTexCoord2f(1, 1); glVertex3f( 0.8,  0.8, 0.0);
-    glTexCoord2f(0, 1); glVertex3f(-0.8,  0.8, 0.0);
-    glEnd();
-    glPopMatrix();
+// Clasifica los bloques de la rejilla: fuera de la pirámide de visión se
+// descartan; los que quedan tan lejos que un quad ocuparía menos de
+// kLodPixels píxeles se dibujan como puntos.
+void KohonenVisualizer::collectVisibleCells() {
+    GLfloat projection[16], modelview[16];
+    glGetFloatv(GL_PROJECTION_MATRIX, projection);
+    glGetFloatv(GL_MODELVIEW_MATRIX, modelview);
+    Frustum frustum(projection, modelview);
+
+    // posición de la cámara en coordenadas de la red: -R^T t
+    float eye[3];
+    for (int k = 0; k < 3; ++k) {
+        eye[k] = -(modelview[k * 4 + 0] * modelview[12] + modelview[k * 4 + 1] * modelview[13] +
+                   modelview[k * 4 + 2] * modelview[14]);
+    }
+    float lod_distance = 2.0f * kQuadHalfSize * focalPixels(viewportHeight) / kLodPixels;
 
-    glDisable(GL_TEXTURE_2D);
+    nearRanges.clear();
+    farRanges.clear();
+    for (std::size_t c = 0; c < grid.cells().size(); ++c) {
+        const GridCell& cell = grid.cells()[c];
+        const float* lo = &cellBounds[c * 6];
+        const float* hi = lo + 3;
+        if (!frustum.intersectsBox(lo, hi)) continue;
+
+        auto& ranges = distanceToBox(eye, lo, hi) < lod_distance ? nearRanges : farRanges;
+        if (!ranges.empty() && ranges.back().first + ranges.back().count == cell.first) {
+            ranges.back().count += cell.count;
+        } else {
+            ranges.push_back({cell.first, cell.count});
+        }
+    }
 }
 
 void KohonenVisualizer::renderScene() {
+    applyProjection();
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     glLoadIdentity();
     glTranslatef(0, 0, zoom);
     glRotatef(angleX, 1, 0, 0);
     glRotatef(angleY, 0, 1, 0);
 
-    if (kohonenNet) {
-        float offsetX = -kohonenNet->getSizeX() + 1.0f;
-        float offsetY = -kohonenNet->getSizeY() + 1.0f;
-        float offsetZ = -kohonenNet->getSizeZ() + 1.0f;
-        glTranslatef(offsetX, offsetY, offsetZ);
-    }
+    if (vertexBuffer) {
+        collectVisibleCells();
 
-    for (const auto& n : neurons) {
-        drawTexturedQuad(n.x, n.y, n.z, n.textureID);
+        // bloques cercanos: quads texturizados, una llamada por página
+        glEnable(GL_TEXTURE_2D);
+        glColor3f(1, 1, 1);
+        glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+        glInterleavedArrays(GL_T2F_V3F, 0, nullptr);
+        for (const auto& page : pages) {
+            drawFirst.clear();
+            drawCount.clear();
+            for (const DrawRange& r : nearRanges) {
+                int begin = std::max(r.first, page.begin);
+                int end = std::min(r.first + r.count, page.end);
+                if (begin >= end) continue;
+                drawFirst.push_back(begin * 4);
+                drawCount.push_back((end - begin) * 4);
+            }
+            if (drawFirst.empty()) continue;
+            glBindTexture(GL_TEXTURE_2D, page.textureID);
+            glMultiDrawArrays(GL_QUADS, drawFirst.data(), drawCount.data(), static_cast<GLsizei>(drawFirst.size()));
+        }
+        glDisable(GL_TEXTURE_2D);
+
+        // bloques lejanos: un punto del color medio por neurona
+        if (!farRanges.empty()) {
+            glPointSize(2.0f * kQuadHalfSize * focalPixels(viewportHeight));
+            glBindBuffer(GL_ARRAY_BUFFER, pointBuffer);
+            glInterleavedArrays(GL_C4UB_V3F, 0, nullptr);
+            drawFirst.clear();
+            drawCount.clear();
+            for (const DrawRange& r : farRanges) {
+                drawFirst.push_back(r.first);
+                drawCount.push_back(r.count);
+            }
+            glMultiDrawArrays(GL_POINTS, drawFirst.data(), drawCount.data(), static_cast<GLsizei>(drawFirst.size()));
+            glDisableClientState(GL_COLOR_ARRAY);
+        }
+
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 
     glutSwapBuffers();
@@ -93,10 +359,9 @@ void KohonenVisualizer::renderScene() {
 
 void KohonenVisualizer::reshape(int w, int h) {
     glViewport(0, 0, w, h);
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    gluPerspective(45, float(w)/h, 0.1, 100);
-    glMatrixMode(GL_MODELVIEW);
+    viewportWidth = std::max(1, w);
+    viewportHeight = std::max(1, h);
+    applyProjection();
 }
 
 void KohonenVisualizer::onMouse(int btn, int state, int x, int y) {
@@ -117,7 +382,7 @@ void KohonenVisualizer::onMotion(int x, int y) {
     glutPostRedisplay();
 }
 
-void KohonenVisualizer::onKeyboard(unsigned char key, int, int) {
-    if (key == 27) exit(0);
+// ESC lo gestiona main: tiene que parar el hilo de entrenamiento antes de salir.
+void KohonenVisualizer::onKeyboard(unsigned char, int, int) {
     glutPostRedisplay();
 }
@@ -0,0 +1,70 @@
+#include "LatticeGrid.hpp"
+#include <algorithm>
+#include <cmath>
+
+LatticeGrid::LatticeGrid(int sizeX, int sizeY, int sizeZ, int cellSide)
+    : position_(sizeX * sizeY * sizeZ) {
+    cellSide = std::max(1, cellSide);
+    order_.reserve(position_.size());
+    for (int cx = 0; cx < sizeX; cx += cellSide) {
+        for (int cy = 0; cy < sizeY; cy += cellSide) {
+            for (int cz = 0; cz < sizeZ; cz += cellSide) {
+                GridCell cell;
+                cell.first = static_cast<int>(order_.size());
+                cell.lo[0] = cx;
+                cell.lo[1] = cy;
+                cell.lo[2] = cz;
+                cell.hi[0] = std::min(cx + cellSide, sizeX) - 1;
+                cell.hi[1] = std::min(cy + cellSide, sizeY) - 1;
+                cell.hi[2] = std::min(cz + cellSide, sizeZ) - 1;
+                for (int x = cell.lo[0]; x <= cell.hi[0]; x++) {
+                    for (int y = cell.lo[1]; y <= cell.hi[1]; y++) {
+                        for (int z = cell.lo[2]; z <= cell.hi[2]; z++) {
+                            int neuron = (x * sizeY + y) * sizeZ + z;
+                            position_[neuron] = static_cast<int>(order_.size());
+                            order_.push_back(neuron);
+                        }
+                    }
+                }
+                cell.count = static_cast<int>(order_.size()) - cell.first;
+                cells_.push_back(cell);
+            }
+        }
+    }
+}
+
+Frustum::Frustum(const float* projection, const float* modelview) {
+    float clip[16];
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++) {
+            float sum = 0.0f;
+            for (int k = 0; k < 4; k++) sum += projection[k * 4 + r] * modelview[c * 4 + k];
+            clip[c * 4 + r] = sum;
+        }
+    }
+    // planos izquierdo, derecho, inferior, superior, cercano y lejano:
+    // fila 3 +/- fila 0, 1, 2 de la matriz de recorte (Gribb-Hartmann)
+    for (int p = 0; p < 6; p++) {
+        int row = p / 2;
+        float sign = (p % 2 == 0) ? 1.0f : -1.0f;
+        float length = 0.0f;
+        for (int k = 0; k < 4; k++) {
+            planes_[p][k] = clip[k * 4 + 3] + sign * clip[k * 4 + row];
+            if (k < 3) length += planes_[p][k] * planes_[p][k];
+        }
+        length = std::sqrt(length);
+        if (length > 0.0f) {
+            for (int k = 0; k < 4; k++) planes_[p][k] /= length;
+        }
+    }
+}
+
+bool Frustum::intersectsBox(const float* lo, const float* hi) const {
+    for (const auto& plane : planes_) {
+        // vértice de la caja más adentro según la normal del plano
+        float d = plane[3];
+        for (int k = 0; k < 3; k++) d += plane[k] * (plane[k] >= 0.0f ? hi[k] : lo[k]);
+        if (d < 0.0f) return false;
+    }
+    return true;
+}
@@ -0,0 +1,40 @@
+#include "LatticeTopology.hpp"
+#include <cmath>
+#include <stdexcept>
+
+const char* topologyName(LatticeTopology topology) {
+    switch (topology) {
+        case LatticeTopology::Rectangular: return "rect";
+        case LatticeTopology::Toroidal: return "torus";
+        case LatticeTopology::BodyCentered: return "bcc";
+    }
+    return "unknown";
+}
+
+LatticeTopology parseTopology(const std::string& name) {
+    if (name == "rect") return LatticeTopology::Rectangular;
+    if (name == "torus") return LatticeTopology::Toroidal;
+    if (name == "bcc") return LatticeTopology::BodyCentered;
+    throw std::runtime_error("Unknown lattice topology: " + name + " (expected rect, torus or bcc)");
+}
+
+void RectangularLattice::reach(float radius, int out[3]) {
+    int r = static_cast<int>(std::floor(radius));
+    out[0] = out[1] = out[2] = r;
+}
+
+void BodyCenteredLattice::reach(float radius, int out[3]) {
+    // |dx +- 1/2| * a <= radio en x, y; |dz| * a/2 <= radio en z
+    out[0] = out[1] = static_cast<int>(std::floor(radius / kCell + 0.5f));
+    out[2] = static_cast<int>(std::floor(2.0f * radius / kCell));
+}
+
+void LatticeShape::position(int i, float out[3]) const {
+    int x, y, z;
+    decode(i, x, y, z);
+    withTopology(topology, [&](auto policy) { decltype(policy)::position(x, y, z, out); });
+}
+
+bool LatticeShape::adjacent(int a, int b) const {
+    return withTopology(topology, [&](auto policy) { return decltype(policy)::adjacent(*this, a, b); });
+}
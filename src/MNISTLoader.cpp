@@ -1,77 +1,56 @@
 #include "MNISTLoader.hpp"
-#include <fstream>
+#include "IdxDataset.hpp"
 #include <stdexcept>
 #include <iostream>
 #include <cstdint>
 
 std::vector<std::vector<float>> MNISTDataset::loadImages(const std::string& filename, int max_images) {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file) throw std::runtime_error("Cannot open MNIST images file: " + filename);
-
-    int32_t magic, num_images, rows, cols;
-    file.read(reinterpret_cast<char*>(&magic), 4);
-    file.read(reinterpret_cast<char*>(&num_images), 4);
-    file.read(reinterpret_cast<char*>(&rows), 4);
-    file.read(reinterpret_cast<char*>(&cols), 4);
-
-    magic = __builtin_bswap32(magic);
-    num_images = __builtin_bswap32(num_images);
-    rows = __builtin_bswap32(rows);
-    cols = __builtin_bswap32(cols);
-
-    if (magic != 2051) throw std::runtime_error("Invalid magic number in MNIST image file");
+    IdxDataset file(filename);
+    if (file.type() != IdxType::UInt8 || file.dims().size() != 3) {
+        throw std::runtime_error("Invalid magic number in MNIST image file");
+    }
 
+    int num_images = file.count();
     if (max_images > 0 && max_images < num_images) {
         num_images = max_images;
     }
 
-    std::vector<std::vector<float>> images;
-    images.reserve(num_images);
-
+    std::vector<std::vector<float>> images(num_images, std::vector<float>(file.sampleSize()));
     for (int i = 0; i < num_images; ++i) {
-        std::vector<float> image(rows * cols);
-        for (int j = 0; j < rows * cols; ++j) {
-            uint8_t pixel;
-            file.read(reinterpret_cast<char*>(&pixel), 1);
-            image[j] = pixel / 255.0f;
-        }
-        images.push_back(std::move(image));
+        file.toFloat(i, images[i].data(), 1.0f / 255.0f);
     }
 
     return images;
 }
 
 std::vector<std::vector<float>> MNISTDataset::loadLabels(const std::string& filename, int max_labels) {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file) throw std::runtime_error("Cannot open MNIST labels file: " + filename);
-
-    int32_t magic, num_labels;
-    file.read(reinterpret_cast<char*>(&magic), 4);
-    file.read(reinterpret_cast<char*>(&num_labels), 4);
-
-    magic = __builtin_bswap32(magic);
-    num_labels = __builtin_bswap32(num_labels);
+    std::vector<uint8_t> indices = loadLabelIndices(filename, max_labels);
+    std::vector<std::vector<float>> labels;
+    labels.reserve(indices.size());
+    for (uint8_t label : indices) {
+        std::vector<float> one_hot(10, 0.0f);
+        one_hot[label] = 1.0f;
+        labels.push_back(std::move(one_hot));
+    }
+    return labels;
+}
 
-    if (magic != 2049) throw std::runtime_error("Invalid magic number in MNIST label file");
+std::vector<uint8_t> MNISTDataset::loadLabelIndices(const std::string& filename, int max_labels) {
+    IdxDataset file(filename);
+    if (file.type() != IdxType::UInt8 || file.dims().size() != 1) {
+        throw std::runtime_error("Invalid magic number in MNIST label file");
+    }
 
+    int num_labels = file.count();
     if (max_labels > 0 && max_labels < num_labels) {
         num_labels = max_labels;
     }
 
-    std::vector<std::vector<float>> labels;
-    labels.reserve(num_labels);
-
-    for (int i = 0; i < num_labels; ++i) {
-        uint8_t label;
-        file.read(reinterpret_cast<char*>(&label), 1);
-
+    const uint8_t* raw = file.rawSample(0);
+    std::vector<uint8_t> labels(raw, raw + num_labels);
+    for (uint8_t label : labels) {
         if (label > 9) throw std::runtime_error("Label out of range");
-
-        std::vector<float> one_hot(10, 0.0f);
-        one_hot[label] = 1.0f;
-        labels.push_back(std::move(one_hot));
     }
-
     return labels;
 }
 
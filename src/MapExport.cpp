@@ -0,0 +1,109 @@
+#include "MapExport.hpp"
+#include "PngWriter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+constexpr int kSliceGap = 4;                          // píxeles entre cortes
+constexpr unsigned char kGapColor[3] = {51, 51, 76};  // fondo del visualizador
+
+// Paleta viridis muestreada en 5 puntos e interpolada linealmente.
+void colormap(float t, unsigned char* out) {
+    static const float kStops[5][3] = {
+        {68, 1, 84}, {59, 82, 139}, {33, 145, 140}, {94, 201, 98}, {253, 231, 37}
+    };
+    t = std::min(1.0f, std::max(0.0f, t)) * 4.0f;
+    int i = std::min(3, static_cast<int>(t));
+    float f = t - i;
+    for (int c = 0; c < 3; c++) {
+        out[c] = static_cast<unsigned char>(kStops[i][c] + f * (kStops[i + 1][c] - kStops[i][c]) + 0.5f);
+    }
+}
+
+float rowDistance(const WeightMatrix& weights, int a, int b) {
+    const float* wa = weights.row(a);
+    const float* wb = weights.row(b);
+    float sum = 0.0f;
+    for (int j = 0; j < weights.cols(); j++) {
+        float d = wa[j] - wb[j];
+        sum += d * d;
+    }
+    return std::sqrt(sum);
+}
+
+}
+
+std::vector<float> computeUMatrix(const Kohonen3D& net) {
+    const LatticeShape& lattice = net.getLattice();
+    const WeightMatrix& weights = net.getCodebook();
+    std::vector<float> values(net.getNumNeurons(), 0.0f);
+    // vecinas según la topología: vuelta en el toro, diagonales en bcc
+    for (int i = 0; i < net.getNumNeurons(); i++) {
+        float sum = 0.0f;
+        int count = 0;
+        lattice.forEachAdjacent(i, [&](int n) {
+            sum += rowDistance(weights, i, n);
+            count++;
+        });
+        values[i] = count > 0 ? sum / count : 0.0f;
+    }
+    return values;
+}
+
+std::vector<float> componentPlane(const Kohonen3D& net, int component) {
+    if (component < 0 || component >= net.getInputDim()) {
+        throw std::runtime_error("Component index out of range: " + std::to_string(component));
+    }
+    std::vector<float> values(net.getNumNeurons());
+    for (int i = 0; i < net.getNumNeurons(); i++) values[i] = net.getWeight(i)[component];
+    return values;
+}
+
+MapImage renderSlices(const std::vector<float>& values, int sizeX, int sizeY, int sizeZ, int cell_size) {
+    if (static_cast<int>(values.size()) != sizeX * sizeY * sizeZ) {
+        throw std::runtime_error("Map values do not match the lattice size");
+    }
+    cell_size = std::max(1, cell_size);
+
+    auto range = std::minmax_element(values.begin(), values.end());
+    float lo = *range.first;
+    float span = *range.second - lo;
+    float scale = span > 0.0f ? 1.0f / span : 0.0f;
+
+    int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(sizeZ))));
+    int rows = (sizeZ + columns - 1) / columns;
+    int slice_w = sizeX * cell_size;
+    int slice_h = sizeY * cell_size;
+
+    MapImage image;
+    image.width = columns * slice_w + (columns + 1) * kSliceGap;
+    image.height = rows * slice_h + (rows + 1) * kSliceGap;
+    image.rgb.resize(static_cast<std::size_t>(image.width) * image.height * 3);
+    for (std::size_t p = 0; p < image.rgb.size(); p += 3) {
+        std::copy(kGapColor, kGapColor + 3, &image.rgb[p]);
+    }
+
+    for (int z = 0; z < sizeZ; z++) {
+        int left = kSliceGap + (z % columns) * (slice_w + kSliceGap);
+        int top = kSliceGap + (z / columns) * (slice_h + kSliceGap);
+        for (int x = 0; x < sizeX; x++) {
+            for (int y = 0; y < sizeY; y++) {
+                unsigned char color[3];
+                colormap((values[(x * sizeY + y) * sizeZ + z] - lo) * scale, color);
+                int px = left + x * cell_size;
+                int py = top + (sizeY - 1 - y) * cell_size;   // y hacia arriba
+                for (int r = 0; r < cell_size; r++) {
+                    unsigned char* out = &image.rgb[(static_cast<std::size_t>(py + r) * image.width + px) * 3];
+                    for (int c = 0; c < cell_size; c++) std::copy(color, color + 3, out + c * 3);
+                }
+            }
+        }
+    }
+    return image;
+}
+
+void writeMapImage(const std::string& filename, const MapImage& image) {
+    writePNG(filename, image.width, image.height, 3, image.rgb.data());
+}
@@ -0,0 +1,40 @@
+#include "MappedFile.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string& filename, Mode mode) : filename_(filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open file: " + filename + " (" + std::strerror(errno) + ")");
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot stat file: " + filename);
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+
+    if (size_ > 0) {
+        int prot = mode == Mode::Private ? (PROT_READ | PROT_WRITE) : PROT_READ;
+        void* p = ::mmap(nullptr, size_, prot, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot mmap file: " + filename + " (" + std::strerror(errno) + ")");
+        }
+        data_ = static_cast<unsigned char*>(p);
+    }
+    // el mapeo sigue siendo válido tras cerrar el descriptor
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data_) ::munmap(data_, size_);
+}
+
+void MappedFile::adviseSequential() const {
+    if (data_) ::madvise(data_, size_, MADV_SEQUENTIAL);
+}
@@ -0,0 +1,65 @@
+#include "Neighborhood.hpp"
+#include <climits>
+#include <cmath>
+
+NeighborhoodStencil::NeighborhoodStencil(float radius, const LatticeShape& lattice) {
+    rebuild(radius, lattice);
+}
+
+void NeighborhoodStencil::rebuild(float radius, const LatticeShape& lattice) {
+    if (radius == radius_ && lattice == lattice_ && !h_.empty()) return;
+    radius_ = radius;
+    lattice_ = lattice;
+    for (auto& runs : runs_) runs.clear();
+    h_.clear();
+    withTopology(lattice.topology, [&](auto policy) { build<decltype(policy)>(); });
+}
+
+template <typename Topology>
+void NeighborhoodStencil::build() {
+    // radio nulo: sólo la ganadora
+    if (radius_ <= 0.0f) {
+        reach_ = 0;
+        for (int v = 0; v < Topology::kVariants; v++) runs_[v].push_back({0, 0, 0, 0, 0});
+        h_.push_back(1.0f);
+        return;
+    }
+
+    int lo[3], hi[3];
+    Topology::reach(radius_, hi);
+    const int sizes[3] = {lattice_.sizeX, lattice_.sizeY, lattice_.sizeZ};
+    reach_ = 0;
+    for (int k = 0; k < 3; k++) {
+        lo[k] = -hi[k];
+        if (Topology::kWraps) {
+            lo[k] = std::max(lo[k], -(sizes[k] - 1) / 2);
+            hi[k] = std::min(hi[k], sizes[k] / 2);
+        }
+        reach_ = std::max(reach_, std::max(-lo[k], hi[k]));
+    }
+
+    // un tramo por (dx, dy) con el rango de dz que cae dentro del radio; en
+    // la BCC los dz de una y otra paridad se intercalan y el tramo cubre
+    // todo el rango (algún dz interior puede quedar algo fuera del radio)
+    float r2 = radius_ * radius_;
+    for (int v = 0; v < Topology::kVariants; v++) {
+        for (int dx = lo[0]; dx <= hi[0]; dx++) {
+            for (int dy = lo[1]; dy <= hi[1]; dy++) {
+                int dz0 = INT_MAX, dz1 = INT_MIN;
+                for (int dz = lo[2]; dz <= hi[2]; dz++) {
+                    if (Topology::offset2(v, dx, dy, dz) > r2) continue;
+                    dz0 = std::min(dz0, dz);
+                    dz1 = std::max(dz1, dz);
+                }
+                if (dz0 > dz1) continue;
+
+                StencilRun run{dx, dy, dz0, dz1, static_cast<int>(h_.size())};
+                for (int dz = dz0; dz <= dz1; dz++) {
+                    float d2 = Topology::offset2(v, dx, dy, dz);
+                    h_.push_back(std::exp(-d2 / (2 * r2)));
+                }
+                runs_[v].push_back(run);
+            }
+        }
+    }
+}
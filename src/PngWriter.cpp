@@ -0,0 +1,71 @@
+#include "PngWriter.hpp"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <zlib.h>
+
+namespace {
+
+void putBigEndian(std::vector<unsigned char>& out, uint32_t value) {
+    out.push_back(static_cast<unsigned char>(value >> 24));
+    out.push_back(static_cast<unsigned char>(value >> 16));
+    out.push_back(static_cast<unsigned char>(value >> 8));
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+// Cada chunk: longitud, tipo, datos y CRC32 de tipo + datos.
+void writeChunk(std::ofstream& file, const char* type, const std::vector<unsigned char>& data) {
+    std::vector<unsigned char> chunk;
+    chunk.reserve(data.size() + 12);
+    putBigEndian(chunk, static_cast<uint32_t>(data.size()));
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    uLong crc = crc32(0L, chunk.data() + 4, static_cast<uInt>(data.size() + 4));
+    putBigEndian(chunk, static_cast<uint32_t>(crc));
+    file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+}
+
+}
+
+void writePNG(const std::string& filename, int width, int height, int channels,
+              const unsigned char* pixels) {
+    static const unsigned char kColorType[] = {0, 0, 4, 2, 6};   // por número de canales
+    if (width <= 0 || height <= 0 || channels < 1 || channels > 4 || channels == 2) {
+        throw std::runtime_error("Unsupported image format for PNG: " + filename);
+    }
+
+    // filas precedidas del filtro 0 (None); zlib se encarga del resto
+    std::size_t row_bytes = static_cast<std::size_t>(width) * channels;
+    std::vector<unsigned char> raw((row_bytes + 1) * height);
+    for (int y = 0; y < height; y++) {
+        raw[y * (row_bytes + 1)] = 0;
+        std::memcpy(&raw[y * (row_bytes + 1) + 1], pixels + y * row_bytes, row_bytes);
+    }
+
+    uLongf compressed_size = compressBound(static_cast<uLong>(raw.size()));
+    std::vector<unsigned char> compressed(compressed_size);
+    if (compress2(compressed.data(), &compressed_size, raw.data(), static_cast<uLong>(raw.size()), 6) != Z_OK) {
+        throw std::runtime_error("Cannot compress PNG data: " + filename);
+    }
+    compressed.resize(compressed_size);
+
+    std::vector<unsigned char> header;
+    putBigEndian(header, static_cast<uint32_t>(width));
+    putBigEndian(header, static_cast<uint32_t>(height));
+    header.push_back(8);                      // bits por canal
+    header.push_back(kColorType[channels]);
+    header.push_back(0);                      // compresión deflate
+    header.push_back(0);                      // filtrado adaptativo
+    header.push_back(0);                      // sin entrelazado
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file) throw std::runtime_error("Cannot create PNG file: " + filename);
+    static const unsigned char kSignature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    file.write(reinterpret_cast<const char*>(kSignature), sizeof(kSignature));
+    writeChunk(file, "IHDR", header);
+    writeChunk(file, "IDAT", compressed);
+    writeChunk(file, "IEND", {});
+    if (!file) throw std::runtime_error("Error writing PNG file: " + filename);
+}
@@ -0,0 +1,74 @@
+#include "PrefetchReader.hpp"
+#include <algorithm>
+
+PrefetchReader::PrefetchReader(SampleSource& source, int chunk_rows, int depth)
+    : source_(source), chunk_rows_(std::max(1, chunk_rows)), slots_(std::max(2, depth)) {
+    for (auto& slot : slots_) {
+        slot.data = AlignedBuffer<float>(static_cast<std::size_t>(chunk_rows_) * source.dim());
+    }
+    worker_ = std::thread(&PrefetchReader::produce, this);
+}
+
+PrefetchReader::~PrefetchReader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+}
+
+void PrefetchReader::produce() {
+    int tail = 0;
+    int capacity = static_cast<int>(slots_.size());
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            // se deja un hueco para el bloque que retiene el consumidor
+            cv_.wait(lock, [&] { return stop_ || filled_ + (holding_ ? 1 : 0) < capacity; });
+            if (stop_) return;
+        }
+
+        Slot& slot = slots_[tail];
+        int rows = 0;
+        try {
+            rows = source_.read(slot.data.data(), chunk_rows_);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            error_ = std::current_exception();
+            done_ = true;
+            cv_.notify_all();
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (rows == 0) {
+            done_ = true;
+            cv_.notify_all();
+            return;
+        }
+        slot.rows = rows;
+        filled_++;
+        tail = (tail + 1) % capacity;
+        cv_.notify_all();
+    }
+}
+
+const float* PrefetchReader::next(int& rows) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (holding_) {
+        holding_ = false;
+        head_ = (head_ + 1) % static_cast<int>(slots_.size());
+        cv_.notify_all();
+    }
+    cv_.wait(lock, [&] { return filled_ > 0 || done_; });
+    if (filled_ == 0) {
+        if (error_) std::rethrow_exception(error_);
+        rows = 0;
+        return nullptr;
+    }
+    filled_--;
+    holding_ = true;
+    rows = slots_[head_].rows;
+    return slots_[head_].data.data();
+}
@@ -0,0 +1,150 @@
+#include "Profiler.hpp"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+
+namespace {
+
+double steadySeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
+
+const char* profilePhaseName(ProfilePhase phase) {
+    switch (phase) {
+        case ProfilePhase::Epoch: return "epoch";
+        case ProfilePhase::BMUSearch: return "bmu_search";
+        case ProfilePhase::Neighborhood: return "neighborhood";
+        case ProfilePhase::WeightUpdate: return "weight_update";
+        case ProfilePhase::BatchAccumulate: return "batch_accumulate";
+        case ProfilePhase::StreamWait: return "stream_wait";
+        case ProfilePhase::Count: break;
+    }
+    return "unknown";
+}
+
+// Registra el hilo al primer uso y libera su ranura al terminar.
+struct ThreadProfileHandle {
+    ThreadProfile* profile;
+    ThreadProfileHandle() : profile(Profiler::instance().acquire()) {}
+    ~ThreadProfileHandle() { Profiler::instance().release(profile); }
+};
+
+Profiler::Profiler() : origin_ticks_(profileTicks()), origin_seconds_(steadySeconds()) {}
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+ThreadProfile& Profiler::local() {
+    thread_local ThreadProfileHandle handle;
+    return *handle.profile;
+}
+
+ThreadProfile* Profiler::acquire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!free_.empty()) {
+        ThreadProfile* profile = free_.back();
+        free_.pop_back();
+        return profile;
+    }
+    profiles_.emplace_back(new ThreadProfile());
+    profiles_.back()->slot = static_cast<int>(profiles_.size()) - 1;
+    return profiles_.back().get();
+}
+
+void Profiler::release(ThreadProfile* profile) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push_back(profile);
+}
+
+void Profiler::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& profile : profiles_) {
+        profile->counters = ProfileCounters();
+        profile->events.clear();
+    }
+    origin_ticks_ = profileTicks();
+    origin_seconds_ = steadySeconds();
+}
+
+// Calibración del reloj contra steady_clock desde el último reset().
+double Profiler::secondsPerTick() const {
+    uint64_t ticks = profileTicks() - origin_ticks_;
+    double seconds = steadySeconds() - origin_seconds_;
+    return ticks > 0 ? seconds / static_cast<double>(ticks) : 0.0;
+}
+
+ProfileReport Profiler::report() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    double scale = secondsPerTick();
+    ProfileReport report;
+    for (const auto& profile : profiles_) {
+        const ProfileCounters& c = profile->counters;
+        for (int p = 0; p < kProfilePhases; p++) {
+            report.seconds[p] += c.ticks[p] * scale;
+            report.calls[p] += c.calls[p];
+        }
+        report.samples += c.samples;
+        report.neuronsTouched += c.neuronsTouched;
+        report.bytesMoved += c.bytesMoved;
+    }
+    return report;
+}
+
+void Profiler::writeChromeTrace(const std::string& filename) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ofstream file(filename);
+    if (!file) throw std::runtime_error("Cannot create trace file: " + filename);
+
+    double micros = secondsPerTick() * 1e6;
+    file << std::fixed << std::setprecision(3) << "{\"traceEvents\":[\n";
+    bool first = true;
+    for (const auto& profile : profiles_) {
+        file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << profile->slot
+             << ",\"args\":{\"name\":\"";
+        if (profile->slot == 0) file << "main";
+        else file << "worker " << profile->slot;
+        file << "\"}}";
+        first = false;
+        for (const TraceEvent& e : profile->events) {
+            // eventos anteriores al último reset() no se pueden situar
+            if (e.start < origin_ticks_) continue;
+            file << ",\n{\"name\":\"" << profilePhaseName(e.phase) << "\",\"cat\":\"train\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                 << profile->slot << ",\"ts\":" << (e.start - origin_ticks_) * micros
+                 << ",\"dur\":" << (e.end - e.start) * micros << "}";
+        }
+    }
+    file << "\n]}\n";
+    if (!file) throw std::runtime_error("Error writing trace file: " + filename);
+}
+
+double ProfileReport::samplesPerSecond() const {
+    double epoch = seconds[static_cast<int>(ProfilePhase::Epoch)];
+    return epoch > 0.0 ? samples / epoch : 0.0;
+}
+
+double ProfileReport::neuronsPerSample() const {
+    return samples > 0 ? static_cast<double>(neuronsTouched) / samples : 0.0;
+}
+
+void ProfileReport::print(std::ostream& out) const {
+    double epoch = seconds[static_cast<int>(ProfilePhase::Epoch)];
+    std::ios::fmtflags flags = out.flags();
+    out << std::fixed << std::setprecision(3);
+    out << "Phase                 time (s)     share      calls\n";
+    for (int p = 0; p < kProfilePhases; p++) {
+        if (calls[p] == 0) continue;
+        out << std::left << std::setw(20) << profilePhaseName(static_cast<ProfilePhase>(p)) << std::right
+            << std::setw(10) << seconds[p] << std::setw(9) << std::setprecision(1)
+            << (epoch > 0.0 ? 100.0 * seconds[p] / epoch : 0.0) << "%" << std::setw(11) << calls[p] << "\n"
+            << std::setprecision(3);
+    }
+    out << "samples/s " << std::setprecision(0) << samplesPerSecond() << ", neurons/sample " << std::setprecision(1)
+        << neuronsPerSample() << ", GB moved " << std::setprecision(3) << bytesMoved / 1e9 << "\n";
+    out.flags(flags);
+}
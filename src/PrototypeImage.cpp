@@ -0,0 +1,159 @@
+#include "PrototypeImage.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+constexpr int kMaxBarGlyphs = 64;     // componentes máximas para el diagrama de barras
+constexpr int kPcaFitRows = 4096;     // filas usadas para estimar la base PCA
+constexpr int kPcaIterations = 50;
+
+unsigned char toByte(float v) {
+    return static_cast<unsigned char>(std::min(1.0f, std::max(0.0f, v)) * 255);
+}
+
+}
+
+void prototypeToRGB(RowView prototype, int width, int height, unsigned char* out) {
+    for (int i = 0; i < width * height; ++i) {
+        float v = std::min(1.0f, std::max(0.0f, prototype[i]));
+        unsigned char val = static_cast<unsigned char>(v * 255);
+        out[i*3 + 0] = val;
+        out[i*3 + 1] = val;
+        out[i*3 + 2] = val;
+    }
+}
+
+ImageTileRenderer::ImageTileRenderer(int width, int height, int channels)
+    : width_(width), height_(height), channels_(channels) {
+    if (channels != 1 && channels != 3) throw std::runtime_error("Image prototypes must have 1 or 3 channels");
+}
+
+void ImageTileRenderer::render(RowView prototype, unsigned char* rgb) const {
+    if (channels_ == 1) {
+        prototypeToRGB(prototype, width_, height_, rgb);
+        return;
+    }
+    for (int i = 0; i < width_ * height_ * 3; ++i) rgb[i] = toByte(prototype[i]);
+}
+
+BarGlyphRenderer::BarGlyphRenderer(const WeightMatrix& codebook)
+    : lo_(codebook.cols(), 0.0f), scale_(codebook.cols(), 0.0f) {
+    int dim = codebook.cols();
+    width_ = dim * std::max(1, 32 / dim);
+    std::vector<float> hi(dim, 0.0f);
+    for (int i = 0; i < codebook.rows(); ++i) {
+        const float* w = codebook.row(i);
+        for (int j = 0; j < dim; ++j) {
+            if (i == 0 || w[j] < lo_[j]) lo_[j] = w[j];
+            if (i == 0 || w[j] > hi[j]) hi[j] = w[j];
+        }
+    }
+    for (int j = 0; j < dim; ++j) {
+        scale_[j] = hi[j] > lo_[j] ? 1.0f / (hi[j] - lo_[j]) : 0.0f;
+    }
+}
+
+void BarGlyphRenderer::render(RowView prototype, unsigned char* rgb) const {
+    static const unsigned char kBackground[3] = {30, 30, 40};
+    static const unsigned char kBar[3] = {90, 170, 255};
+    int dim = prototype.size();
+    int bar_width = width_ / dim;
+    // la fila 0 es la base del quad: las barras crecen hacia arriba
+    for (int j = 0; j < dim; ++j) {
+        float t = std::min(1.0f, std::max(0.0f, (prototype[j] - lo_[j]) * scale_[j]));
+        int filled = static_cast<int>(std::lround(t * kHeight));
+        for (int x = j * bar_width; x < (j + 1) * bar_width; ++x) {
+            bool gap = bar_width >= 3 && x == (j + 1) * bar_width - 1;
+            for (int y = 0; y < kHeight; ++y) {
+                const unsigned char* color = (!gap && y < filled) ? kBar : kBackground;
+                std::copy(color, color + 3, rgb + (y * width_ + x) * 3);
+            }
+        }
+    }
+}
+
+// Componentes principales por iteración de potencias sobre la covarianza
+// (sin formarla: C v = sum_i (x_i - m) ((x_i - m) . v)), con deflación
+// ortogonalizando contra los ejes ya encontrados.
+PcaColorRenderer::PcaColorRenderer(const WeightMatrix& codebook) : mean_(codebook.cols(), 0.0f) {
+    int dim = codebook.cols();
+    int rows = codebook.rows();
+    int step = std::max(1, rows / kPcaFitRows);
+
+    int fit_rows = 0;
+    for (int i = 0; i < rows; i += step, ++fit_rows) {
+        const float* w = codebook.row(i);
+        for (int j = 0; j < dim; ++j) mean_[j] += w[j];
+    }
+    for (float& m : mean_) m /= std::max(1, fit_rows);
+
+    std::vector<float> centered(dim), next(dim);
+    for (int a = 0; a < 3; ++a) {
+        std::vector<float>& axis = axes_[a];
+        axis.assign(dim, 0.0f);
+        for (int j = 0; j < dim; ++j) axis[j] = 1.0f + static_cast<float>((j * (a + 3)) % 7);
+
+        for (int it = 0; it < kPcaIterations; ++it) {
+            std::fill(next.begin(), next.end(), 0.0f);
+            for (int i = 0; i < rows; i += step) {
+                const float* w = codebook.row(i);
+                float dot = 0.0f;
+                for (int j = 0; j < dim; ++j) {
+                    centered[j] = w[j] - mean_[j];
+                    dot += centered[j] * axis[j];
+                }
+                for (int j = 0; j < dim; ++j) next[j] += dot * centered[j];
+            }
+            for (int b = 0; b < a; ++b) {
+                float dot = 0.0f;
+                for (int j = 0; j < dim; ++j) dot += next[j] * axes_[b][j];
+                for (int j = 0; j < dim; ++j) next[j] -= dot * axes_[b][j];
+            }
+            float norm = 0.0f;
+            for (float v : next) norm += v * v;
+            norm = std::sqrt(norm);
+            if (norm == 0.0f) break;   // sin varianza en esta dirección
+            for (int j = 0; j < dim; ++j) axis[j] = next[j] / norm;
+        }
+    }
+
+    // rango de las proyecciones sobre todo el codebook
+    float hi[3];
+    for (int a = 0; a < 3; ++a) {
+        lo_[a] = 0.0f;
+        hi[a] = 0.0f;
+    }
+    for (int i = 0; i < rows; ++i) {
+        const float* w = codebook.row(i);
+        for (int a = 0; a < 3; ++a) {
+            float p = 0.0f;
+            for (int j = 0; j < dim; ++j) p += (w[j] - mean_[j]) * axes_[a][j];
+            if (i == 0 || p < lo_[a]) lo_[a] = p;
+            if (i == 0 || p > hi[a]) hi[a] = p;
+        }
+    }
+    for (int a = 0; a < 3; ++a) scale_[a] = hi[a] > lo_[a] ? 1.0f / (hi[a] - lo_[a]) : 0.0f;
+}
+
+void PcaColorRenderer::render(RowView prototype, unsigned char* rgb) const {
+    unsigned char color[3];
+    for (int a = 0; a < 3; ++a) {
+        float p = 0.0f;
+        for (int j = 0; j < prototype.size(); ++j) p += (prototype[j] - mean_[j]) * axes_[a][j];
+        color[a] = scale_[a] > 0.0f ? toByte((p - lo_[a]) * scale_[a]) : 128;
+    }
+    for (int i = 0; i < kTileSize * kTileSize; ++i) std::copy(color, color + 3, rgb + i * 3);
+}
+
+std::unique_ptr<PrototypeRenderer> makePrototypeRenderer(const SampleShape& shape, const WeightMatrix& codebook) {
+    if (shape.size() != codebook.cols()) {
+        throw std::runtime_error("Sample shape " + shape.toString() + " does not match the codebook dimension");
+    }
+    if (shape.isImage()) {
+        return std::unique_ptr<PrototypeRenderer>(new ImageTileRenderer(shape.width(), shape.height(), shape.channels()));
+    }
+    if (shape.size() <= kMaxBarGlyphs) return std::unique_ptr<PrototypeRenderer>(new BarGlyphRenderer(codebook));
+    return std::unique_ptr<PrototypeRenderer>(new PcaColorRenderer(codebook));
+}
@@ -0,0 +1,389 @@
+#include "QuantizedCodebook.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define KOHONEN_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr int kInt8Scale = 127;
+constexpr int kInputScale = 255;
+
+int roundUp(int value, int multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+uint16_t floatToHalf(float f) {
+    uint32_t x;
+    std::memcpy(&x, &f, sizeof(x));
+    uint32_t sign = (x >> 16) & 0x8000u;
+    uint32_t raw_exp = (x >> 23) & 0xffu;
+    uint32_t mant = x & 0x7fffffu;
+    if (raw_exp == 0xffu) return static_cast<uint16_t>(sign | 0x7c00u | (mant ? 0x200u : 0u));
+
+    int exp = static_cast<int>(raw_exp) - 127 + 15;
+    if (exp >= 31) return static_cast<uint16_t>(sign | 0x7c00u);
+    if (exp <= 0) {
+        if (exp < -10) return static_cast<uint16_t>(sign);
+        mant |= 0x800000u;
+        int shift = 14 - exp;
+        uint32_t half = mant >> shift;
+        uint32_t rem = mant & ((1u << shift) - 1);
+        uint32_t mid = 1u << (shift - 1);
+        if (rem > mid || (rem == mid && (half & 1u))) half++;
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    uint32_t half = sign | (static_cast<uint32_t>(exp) << 10) | (mant >> 13);
+    uint32_t rem = mant & 0x1fffu;
+    // redondeo al par más cercano; el acarreo pasa correctamente al exponente
+    if (rem > 0x1000u || (rem == 0x1000u && (half & 1u))) half++;
+    return static_cast<uint16_t>(half);
+}
+
+float halfToFloat(uint16_t h) {
+    uint32_t sign = static_cast<uint32_t>(h & 0x8000u) << 16;
+    uint32_t exp = (h >> 10) & 0x1fu;
+    uint32_t mant = h & 0x3ffu;
+    uint32_t x;
+    if (exp == 0) {
+        if (mant == 0) {
+            x = sign;
+        } else {
+            exp = 127 - 15 + 1;
+            while (!(mant & 0x400u)) {
+                mant <<= 1;
+                exp--;
+            }
+            x = sign | (exp << 23) | ((mant & 0x3ffu) << 13);
+        }
+    } else if (exp == 31) {
+        x = sign | 0x7f800000u | (mant << 13);
+    } else {
+        x = sign | ((exp - 15 + 127) << 23) | (mant << 13);
+    }
+    float f;
+    std::memcpy(&f, &x, sizeof(f));
+    return f;
+}
+
+// Los kernels reciben la entrada ya rellenada con ceros hasta stride, así
+// que recorren filas completas sin cola escalar.
+
+using Int8Kernel = int (*)(const uint8_t* input, const int8_t* weights, const int64_t* norms, int stride, int rows);
+using HalfKernel = int (*)(const float* input, const uint16_t* weights, int stride, int rows);
+
+// score = 255 ||w_q||^2 - 2 * 127 * (x_q . w_q), proporcional a ||x - w||^2 - ||x||^2
+inline void updateBestScore(int64_t norm, int32_t dot, int i, int64_t& best_score, int& best) {
+    int64_t score = norm - 2 * kInt8Scale * static_cast<int64_t>(dot);
+    if (score < best_score) {
+        best_score = score;
+        best = i;
+    }
+}
+
+int int8Scalar(const uint8_t* input, const int8_t* weights, const int64_t* norms, int stride, int rows) {
+    int best = 0;
+    int64_t best_score = std::numeric_limits<int64_t>::max();
+    for (int i = 0; i < rows; i++) {
+        const int8_t* w = weights + static_cast<std::size_t>(i) * stride;
+        int32_t dot = 0;
+        for (int j = 0; j < stride; j++) dot += static_cast<int32_t>(input[j]) * w[j];
+        updateBestScore(norms[i], dot, i, best_score, best);
+    }
+    return best;
+}
+
+float halfDistanceScalar(const float* input, const uint16_t* w, int stride) {
+    float dist = 0.0f;
+    for (int j = 0; j < stride; j++) {
+        float diff = input[j] - halfToFloat(w[j]);
+        dist += diff * diff;
+    }
+    return dist;
+}
+
+int halfScalar(const float* input, const uint16_t* weights, int stride, int rows) {
+    int best = 0;
+    float best_dist = std::numeric_limits<float>::max();
+    for (int i = 0; i < rows; i++) {
+        float dist = halfDistanceScalar(input, weights + static_cast<std::size_t>(i) * stride, stride);
+        if (dist < best_dist) {
+            best_dist = dist;
+            best = i;
+        }
+    }
+    return best;
+}
+
+#ifdef KOHONEN_X86
+
+__attribute__((target("avx2")))
+inline int32_t hsumEpi32(__m256i v) {
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(s);
+}
+
+// AVX2: se extienden ambos operandos a 16 bits y vpmaddwd acumula en 32 bits
+// sin la saturación que tendría vpmaddubsw con pesos de 7 bits.
+__attribute__((target("avx2")))
+int int8AVX2(const uint8_t* input, const int8_t* weights, const int64_t* norms, int stride, int rows) {
+    int best = 0;
+    int64_t best_score = std::numeric_limits<int64_t>::max();
+    int i = 0;
+    for (; i + 4 <= rows; i += 4) {
+        const int8_t* w0 = weights + static_cast<std::size_t>(i) * stride;
+        const int8_t* w1 = w0 + stride;
+        const int8_t* w2 = w1 + stride;
+        const int8_t* w3 = w2 + stride;
+        __m256i a0 = _mm256_setzero_si256(), a1 = _mm256_setzero_si256();
+        __m256i a2 = _mm256_setzero_si256(), a3 = _mm256_setzero_si256();
+        for (int j = 0; j < stride; j += 16) {
+            __m256i x = _mm256_cvtepu8_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(input + j)));
+            a0 = _mm256_add_epi32(a0, _mm256_madd_epi16(x, _mm256_cvtepi8_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(w0 + j)))));
+            a1 = _mm256_add_epi32(a1, _mm256_madd_epi16(x, _mm256_cvtepi8_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(w1 + j)))));
+            a2 = _mm256_add_epi32(a2, _mm256_madd_epi16(x, _mm256_cvtepi8_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(w2 + j)))));
+            a3 = _mm256_add_epi32(a3, _mm256_madd_epi16(x, _mm256_cvtepi8_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(w3 + j)))));
+        }
+        updateBestScore(norms[i], hsumEpi32(a0), i, best_score, best);
+        updateBestScore(norms[i + 1], hsumEpi32(a1), i + 1, best_score, best);
+        updateBestScore(norms[i + 2], hsumEpi32(a2), i + 2, best_score, best);
+        updateBestScore(norms[i + 3], hsumEpi32(a3), i + 3, best_score, best);
+    }
+    for (; i < rows; i++) {
+        const int8_t* w = weights + static_cast<std::size_t>(i) * stride;
+        __m256i a = _mm256_setzero_si256();
+        for (int j = 0; j < stride; j += 16) {
+            __m256i x = _mm256_cvtepu8_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(input + j)));
+            a = _mm256_add_epi32(a, _mm256_madd_epi16(x, _mm256_cvtepi8_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(w + j)))));
+        }
+        updateBestScore(norms[i], hsumEpi32(a), i, best_score, best);
+    }
+    return best;
+}
+
+// AVX512-VNNI: vpdpbusd multiplica u8 x s8 y acumula en 32 bits en una
+// sola instrucción, 64 dimensiones por paso.
+__attribute__((target("avx512f,avx512bw,avx512vnni")))
+int int8VNNI(const uint8_t* input, const int8_t* weights, const int64_t* norms, int stride, int rows) {
+    int best = 0;
+    int64_t best_score = std::numeric_limits<int64_t>::max();
+    int i = 0;
+    for (; i + 4 <= rows; i += 4) {
+        const int8_t* w0 = weights + static_cast<std::size_t>(i) * stride;
+        const int8_t* w1 = w0 + stride;
+        const int8_t* w2 = w1 + stride;
+        const int8_t* w3 = w2 + stride;
+        __m512i a0 = _mm512_setzero_si512(), a1 = _mm512_setzero_si512();
+        __m512i a2 = _mm512_setzero_si512(), a3 = _mm512_setzero_si512();
+        for (int j = 0; j < stride; j += 64) {
+            __m512i x = _mm512_load_si512(input + j);
+            a0 = _mm512_dpbusd_epi32(a0, x, _mm512_load_si512(w0 + j));
+            a1 = _mm512_dpbusd_epi32(a1, x, _mm512_load_si512(w1 + j));
+            a2 = _mm512_dpbusd_epi32(a2, x, _mm512_load_si512(w2 + j));
+            a3 = _mm512_dpbusd_epi32(a3, x, _mm512_load_si512(w3 + j));
+        }
+        updateBestScore(norms[i], _mm512_reduce_add_epi32(a0), i, best_score, best);
+        updateBestScore(norms[i + 1], _mm512_reduce_add_epi32(a1), i + 1, best_score, best);
+        updateBestScore(norms[i + 2], _mm512_reduce_add_epi32(a2), i + 2, best_score, best);
+        updateBestScore(norms[i + 3], _mm512_reduce_add_epi32(a3), i + 3, best_score, best);
+    }
+    for (; i < rows; i++) {
+        const int8_t* w = weights + static_cast<std::size_t>(i) * stride;
+        __m512i a = _mm512_setzero_si512();
+        for (int j = 0; j < stride; j += 64) {
+            a = _mm512_dpbusd_epi32(a, _mm512_load_si512(input + j), _mm512_load_si512(w + j));
+        }
+        updateBestScore(norms[i], _mm512_reduce_add_epi32(a), i, best_score, best);
+    }
+    return best;
+}
+
+__attribute__((target("avx2,fma,f16c")))
+inline float hsumPs(__m256 v) {
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_movehdup_ps(s));
+    return _mm_cvtss_f32(s);
+}
+
+__attribute__((target("avx2,fma,f16c")))
+int halfF16C(const float* input, const uint16_t* weights, int stride, int rows) {
+    int best = 0;
+    float best_dist = std::numeric_limits<float>::max();
+    for (int i = 0; i < rows; i++) {
+        const uint16_t* w = weights + static_cast<std::size_t>(i) * stride;
+        __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+        for (int j = 0; j < stride; j += 16) {
+            __m256 d0 = _mm256_sub_ps(_mm256_load_ps(input + j),
+                                      _mm256_cvtph_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(w + j))));
+            __m256 d1 = _mm256_sub_ps(_mm256_load_ps(input + j + 8),
+                                      _mm256_cvtph_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(w + j + 8))));
+            a0 = _mm256_fmadd_ps(d0, d0, a0);
+            a1 = _mm256_fmadd_ps(d1, d1, a1);
+        }
+        float dist = hsumPs(_mm256_add_ps(a0, a1));
+        if (dist < best_dist) {
+            best_dist = dist;
+            best = i;
+        }
+    }
+    return best;
+}
+
+#endif
+
+Int8Kernel selectInt8Kernel() {
+    static const Int8Kernel kernel = [] {
+        SimdLevel level = BMUSearch::detectSimdLevel();
+        (void)level;
+#ifdef KOHONEN_X86
+        if (level >= SimdLevel::AVX512 && __builtin_cpu_supports("avx512bw") &&
+            __builtin_cpu_supports("avx512vnni")) {
+            return static_cast<Int8Kernel>(int8VNNI);
+        }
+        if (level >= SimdLevel::AVX2) return static_cast<Int8Kernel>(int8AVX2);
+#endif
+        return static_cast<Int8Kernel>(int8Scalar);
+    }();
+    return kernel;
+}
+
+HalfKernel selectHalfKernel() {
+    static const HalfKernel kernel = [] {
+        SimdLevel level = BMUSearch::detectSimdLevel();
+        (void)level;
+#ifdef KOHONEN_X86
+        if (level >= SimdLevel::AVX2 && __builtin_cpu_supports("f16c")) return static_cast<HalfKernel>(halfF16C);
+#endif
+        return static_cast<HalfKernel>(halfScalar);
+    }();
+    return kernel;
+}
+
+}
+
+void QuantizationReport::print(std::ostream& out) const {
+    out << "Quantized codebook: " << bytesQuantized << " bytes (fp32: " << bytesFp32 << " bytes)\n"
+        << "  BMU agreement with fp32: " << bmuAgreement * 100.0f << "% over " << samples << " samples\n"
+        << "  Quantization error fp32: " << quantErrorFp32
+        << ", quantized: " << quantErrorQuantized << "\n";
+}
+
+QuantizedCodebook::QuantizedCodebook(const Kohonen3D& net, QuantFormat format)
+    : format_(format), rows_(net.getNumNeurons()), cols_(net.getInputDim()) {
+    if (format_ == QuantFormat::Int8) {
+        stride_ = roundUp(cols_, 64);
+        int8Weights_ = AlignedBuffer<int8_t>(static_cast<std::size_t>(rows_) * stride_);
+        normTerms_ = AlignedBuffer<int64_t>(rows_);
+
+        float lo = std::numeric_limits<float>::max(), hi = std::numeric_limits<float>::lowest();
+        for (int i = 0; i < rows_; i++) {
+            RowView w = net.getWeight(i);
+            for (int j = 0; j < cols_; j++) {
+                lo = std::min(lo, w[j]);
+                hi = std::max(hi, w[j]);
+            }
+        }
+        if (rows_ == 0 || cols_ == 0) lo = hi = 0.0f;
+        offset_ = lo;
+        invRange_ = hi > lo ? 1.0f / (hi - lo) : 1.0f;
+        for (int b = 0; b < 256; b++) byteTable_[b] = quantizeInput(b * (1.0f / kInputScale));
+
+        for (int i = 0; i < rows_; i++) {
+            RowView w = net.getWeight(i);
+            int8_t* q = int8Weights_.data() + static_cast<std::size_t>(i) * stride_;
+            int64_t norm = 0;
+            for (int j = 0; j < cols_; j++) {
+                // el máximo puede pasar de 1 en el último bit
+                float v = std::min(1.0f, (w[j] - offset_) * invRange_);
+                q[j] = static_cast<int8_t>(std::lround(v * kInt8Scale));
+                norm += static_cast<int64_t>(q[j]) * q[j];
+            }
+            normTerms_.data()[i] = kInputScale * norm;
+        }
+    } else {
+        stride_ = roundUp(cols_, 32);
+        halfWeights_ = AlignedBuffer<uint16_t>(static_cast<std::size_t>(rows_) * stride_);
+        for (int i = 0; i < rows_; i++) {
+            RowView w = net.getWeight(i);
+            uint16_t* q = halfWeights_.data() + static_cast<std::size_t>(i) * stride_;
+            for (int j = 0; j < cols_; j++) q[j] = floatToHalf(w[j]);
+        }
+    }
+}
+
+uint8_t QuantizedCodebook::quantizeInput(float v) const {
+    float scaled = std::min(1.0f, std::max(0.0f, (v - offset_) * invRange_));
+    return static_cast<uint8_t>(std::lround(scaled * kInputScale));
+}
+
+std::size_t QuantizedCodebook::sizeBytes() const {
+    if (format_ == QuantFormat::Int8) {
+        return int8Weights_.size() * sizeof(int8_t) + normTerms_.size() * sizeof(int64_t);
+    }
+    return halfWeights_.size() * sizeof(uint16_t);
+}
+
+int QuantizedCodebook::find(const uint8_t* input) const {
+    if (format_ == QuantFormat::Int8) {
+        thread_local AlignedBuffer<uint8_t> padded;
+        if (padded.size() != static_cast<std::size_t>(stride_)) padded = AlignedBuffer<uint8_t>(stride_);
+        for (int j = 0; j < cols_; j++) padded.data()[j] = byteTable_[input[j]];
+        return selectInt8Kernel()(padded.data(), int8Weights_.data(), normTerms_.data(), stride_, rows_);
+    }
+
+    thread_local AlignedBuffer<float> padded;
+    if (padded.size() != static_cast<std::size_t>(stride_)) padded = AlignedBuffer<float>(stride_);
+    for (int j = 0; j < cols_; j++) padded.data()[j] = input[j] * (1.0f / kInputScale);
+    return selectHalfKernel()(padded.data(), halfWeights_.data(), stride_, rows_);
+}
+
+int QuantizedCodebook::find(const float* input) const {
+    if (format_ == QuantFormat::Int8) {
+        thread_local AlignedBuffer<uint8_t> padded;
+        if (padded.size() != static_cast<std::size_t>(stride_)) padded = AlignedBuffer<uint8_t>(stride_);
+        for (int j = 0; j < cols_; j++) padded.data()[j] = quantizeInput(input[j]);
+        return selectInt8Kernel()(padded.data(), int8Weights_.data(), normTerms_.data(), stride_, rows_);
+    }
+
+    thread_local AlignedBuffer<float> padded;
+    if (padded.size() != static_cast<std::size_t>(stride_)) padded = AlignedBuffer<float>(stride_);
+    std::memcpy(padded.data(), input, cols_ * sizeof(float));
+    return selectHalfKernel()(padded.data(), halfWeights_.data(), stride_, rows_);
+}
+
+QuantizationReport QuantizedCodebook::compare(const Kohonen3D& net, const std::vector<Vector>& samples) const {
+    QuantizationReport report;
+    report.samples = static_cast<int>(samples.size());
+    report.bytesFp32 = net.getCodebook().sizeBytes();
+    report.bytesQuantized = sizeBytes();
+    if (samples.empty()) return report;
+
+    BMUSearch bmu;
+    const WeightMatrix& codebook = net.getCodebook();
+    int agree = 0;
+    double qe_fp32 = 0.0, qe_quant = 0.0;
+    for (const auto& x : samples) {
+        BMUResult exact = bmu.find(codebook, x.data());
+        int approx = find(x.data());
+        if (approx == exact.index) agree++;
+
+        const float* w = codebook.row(approx);
+        float dist = 0.0f;
+        for (int j = 0; j < cols_; j++) dist += (x[j] - w[j]) * (x[j] - w[j]);
+        qe_fp32 += std::sqrt(exact.distance);
+        qe_quant += std::sqrt(dist);
+    }
+    report.bmuAgreement = static_cast<float>(agree) / samples.size();
+    report.quantErrorFp32 = static_cast<float>(qe_fp32 / samples.size());
+    report.quantErrorQuantized = static_cast<float>(qe_quant / samples.size());
+    return report;
+}
@@ -0,0 +1,45 @@
+#include "SampleShape.hpp"
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+int SampleShape::size() const {
+    if (dims.empty()) return 0;
+    int total = 1;
+    for (int d : dims) total *= d;
+    return total;
+}
+
+bool SampleShape::isImage() const {
+    return dims.size() == 2 || (dims.size() == 3 && (dims[2] == 1 || dims[2] == 3));
+}
+
+std::string SampleShape::toString() const {
+    std::string text;
+    for (std::size_t i = 0; i < dims.size(); i++) {
+        if (i > 0) text += 'x';
+        text += std::to_string(dims[i]);
+    }
+    return text;
+}
+
+SampleShape SampleShape::parse(const std::string& text) {
+    SampleShape shape;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, 'x')) {
+        char* end = nullptr;
+        long value = std::strtol(item.c_str(), &end, 10);
+        if (item.empty() || *end != '\0' || value <= 0) {
+            throw std::runtime_error("Invalid sample shape: " + text);
+        }
+        shape.dims.push_back(static_cast<int>(value));
+    }
+    if (shape.dims.empty() || shape.dims.size() > 3) throw std::runtime_error("Invalid sample shape: " + text);
+    return shape;
+}
+
+SampleShape SampleShape::guess(int dim) {
+    if (dim == 28 * 28) return SampleShape{{28, 28}};
+    return vector(dim);
+}
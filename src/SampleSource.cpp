@@ -0,0 +1,208 @@
+#include "SampleSource.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+
+IdxSampleSource::IdxSampleSource(const std::string& filename, float scale, int max_samples)
+    : dataset_(filename), scale_(scale), count_(dataset_.count()) {
+    if (max_samples > 0 && max_samples < count_) count_ = max_samples;
+}
+
+int IdxSampleSource::read(float* out, int max_rows) {
+    int rows = std::min(max_rows, count_ - cursor_);
+    int d = dim();
+    for (int r = 0; r < rows; r++) {
+        dataset_.toFloat(cursor_ + r, out + static_cast<std::size_t>(r) * d, scale_);
+    }
+    cursor_ += rows;
+    return rows;
+}
+
+SampleShape IdxSampleSource::shape() const {
+    const std::vector<int>& dims = dataset_.dims();
+    if (dims.size() <= 1) return SampleShape::vector(1);
+    return SampleShape{std::vector<int>(dims.begin() + 1, dims.end())};
+}
+
+GeneratorSampleSource::GeneratorSampleSource(int dim, Generator generator, long long samples_per_epoch)
+    : dim_(dim), generator_(std::move(generator)), samples_per_epoch_(samples_per_epoch) {}
+
+int GeneratorSampleSource::read(float* out, int max_rows) {
+    int rows = 0;
+    while (rows < max_rows && !exhausted_) {
+        if (samples_per_epoch_ >= 0 && produced_ >= samples_per_epoch_) break;
+        if (!generator_(out + static_cast<std::size_t>(rows) * dim_)) {
+            exhausted_ = true;
+            break;
+        }
+        rows++;
+        produced_++;
+    }
+    return rows;
+}
+
+SubsetSampleSource::SubsetSampleSource(const std::vector<std::vector<float>>& samples, const std::vector<int>& indices)
+    : samples_(samples), indices_(indices), dim_(indices.empty() ? 0 : static_cast<int>(samples[indices.front()].size())) {}
+
+int SubsetSampleSource::read(float* out, int max_rows) {
+    int rows = static_cast<int>(std::min<std::size_t>(max_rows, indices_.size() - cursor_));
+    for (int r = 0; r < rows; r++) {
+        const std::vector<float>& x = samples_[indices_[cursor_ + r]];
+        std::copy(x.begin(), x.end(), out + static_cast<std::size_t>(r) * dim_);
+    }
+    cursor_ += rows;
+    return rows;
+}
+
+RawStreamSampleSource::RawStreamSampleSource(int fd, int dim) : fd_(fd), dim_(dim) {}
+
+int RawStreamSampleSource::read(float* out, int max_rows) {
+    std::size_t row_bytes = static_cast<std::size_t>(dim_) * sizeof(float);
+    std::size_t wanted = row_bytes * max_rows;
+    std::size_t got = 0;
+    char* dst = reinterpret_cast<char*>(out);
+    while (got < wanted) {
+        ssize_t n = ::read(fd_, dst + got, wanted - got);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(std::string("Error reading sample stream: ") + std::strerror(errno));
+        }
+        if (n == 0) break;
+        got += static_cast<std::size_t>(n);
+    }
+    // una fila incompleta al final del flujo se descarta
+    return static_cast<int>(got / row_bytes);
+}
+
+void RawStreamSampleSource::rewind() {
+    if (::lseek(fd_, 0, SEEK_SET) < 0) {
+        throw std::runtime_error("Sample stream is not seekable; it can only be used for one epoch");
+    }
+}
+
+Float32FileSampleSource::Float32FileSampleSource(const std::string& filename, const SampleShape& shape)
+    : file_(filename), shape_(shape) {
+    if (shape_.size() <= 0) throw std::runtime_error("A sample shape is required for raw float32 file: " + filename);
+    std::size_t row_bytes = static_cast<std::size_t>(shape_.size()) * sizeof(float);
+    if (file_.size() % row_bytes != 0) {
+        throw std::runtime_error("Raw float32 file size is not a multiple of the row size: " + filename);
+    }
+    count_ = static_cast<long long>(file_.size() / row_bytes);
+    file_.adviseSequential();
+}
+
+int Float32FileSampleSource::read(float* out, int max_rows) {
+    int rows = static_cast<int>(std::min<long long>(max_rows, count_ - cursor_));
+    std::size_t row_bytes = static_cast<std::size_t>(dim()) * sizeof(float);
+    if (rows > 0) std::memcpy(out, file_.data() + cursor_ * row_bytes, rows * row_bytes);
+    cursor_ += rows;
+    return rows;
+}
+
+CsvSampleSource::CsvSampleSource(const std::string& filename, char delimiter, const SampleShape& shape)
+    : file_(filename), delimiter_(delimiter) {
+    file_.adviseSequential();
+    begin_ = reinterpret_cast<const char*>(file_.data());
+    end_ = begin_ + file_.size();
+
+    // primera línea no vacía: cabecera si no es numérica
+    const char* p = begin_;
+    long long line = 1;
+    bool header_checked = false;
+    while (p < end_) {
+        const char* start = p;
+        int fields = parseLine(p, nullptr, 0);
+        if (fields > 0) {
+            dim_ = fields;
+            begin_ = start;
+            first_line_ = line;
+            break;
+        }
+        if (fields < 0) {
+            if (header_checked) {
+                throw std::runtime_error("Malformed CSV row at " + filename + ":" + std::to_string(line));
+            }
+            header_checked = true;
+        }
+        line++;
+    }
+    if (dim_ == 0) throw std::runtime_error("CSV file has no numeric rows: " + filename);
+
+    shape_ = shape.empty() ? SampleShape::vector(dim_) : shape;
+    if (shape_.size() != dim_) {
+        throw std::runtime_error("CSV rows have " + std::to_string(dim_) + " columns, which does not match shape " +
+                                 shape_.toString() + ": " + filename);
+    }
+    rewind();
+}
+
+void CsvSampleSource::rewind() {
+    cursor_ = begin_;
+    line_ = first_line_;
+}
+
+int CsvSampleSource::parseLine(const char*& p, float* out, int max_fields) const {
+    const char* line_end = static_cast<const char*>(std::memchr(p, '\n', end_ - p));
+    if (!line_end) line_end = end_;
+    const char* q = p;
+    const char* stop = line_end;
+    if (stop > q && stop[-1] == '\r') stop--;
+    p = line_end < end_ ? line_end + 1 : end_;
+
+    auto skip_blanks = [&]() {
+        while (q < stop && (*q == ' ' || (*q == '\t' && delimiter_ != '\t'))) q++;
+    };
+    skip_blanks();
+    if (q == stop) return 0;
+
+    int fields = 0;
+    while (true) {
+        skip_blanks();
+        if (q < stop && *q == '+') q++;   // from_chars no acepta '+'
+        float value;
+        auto result = std::from_chars(q, stop, value);
+        if (result.ec != std::errc()) return -1;
+        if (out && fields < max_fields) out[fields] = value;
+        fields++;
+        q = result.ptr;
+        skip_blanks();
+        if (q == stop) return fields;
+        if (*q != delimiter_) return -1;
+        q++;
+    }
+}
+
+int CsvSampleSource::read(float* out, int max_rows) {
+    int rows = 0;
+    while (rows < max_rows && cursor_ < end_) {
+        int fields = parseLine(cursor_, out + static_cast<std::size_t>(rows) * dim_, dim_);
+        line_++;
+        if (fields == 0) continue;
+        if (fields != dim_) {
+            throw std::runtime_error("Malformed CSV row at " + file_.filename() + ":" + std::to_string(line_ - 1));
+        }
+        rows++;
+    }
+    return rows;
+}
+
+std::unique_ptr<SampleSource> openSampleSource(const std::string& filename, const SampleShape& shape) {
+    std::string extension;
+    std::size_t dot = filename.find_last_of('.');
+    std::size_t slash = filename.find_last_of('/');
+    if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) {
+        extension = filename.substr(dot + 1);
+        for (char& c : extension) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+
+    if (extension == "csv") return std::unique_ptr<SampleSource>(new CsvSampleSource(filename, ',', shape));
+    if (extension == "tsv") return std::unique_ptr<SampleSource>(new CsvSampleSource(filename, '\t', shape));
+    if (extension == "f32" || extension == "raw" || extension == "bin") {
+        return std::unique_ptr<SampleSource>(new Float32FileSampleSource(filename, shape));
+    }
+    return std::unique_ptr<SampleSource>(new IdxSampleSource(filename));
+}
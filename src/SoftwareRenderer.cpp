@@ -0,0 +1,168 @@
+#include "SoftwareRenderer.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// Mismo tamaño de quad que KohonenVisualizer; los planos de recorte salen
+// de kCameraNear y cameraFarPlane, compartidos con él.
+constexpr float kQuadHalfSize = 0.8f;
+constexpr float kSpacing = 2.0f;
+constexpr unsigned char kBackground[3] = {51, 51, 76};
+constexpr float kDegToRad = 3.14159265358979f / 180.0f;
+
+struct Vec3 {
+    float x, y, z;
+};
+
+// glRotatef(angleX, 1, 0, 0) seguido de glRotatef(angleY, 0, 1, 0)
+Vec3 rotate(const Vec3& p, float cx, float sx, float cy, float sy) {
+    Vec3 r{cy * p.x + sy * p.z, p.y, -sy * p.x + cy * p.z};
+    return {r.x, cx * r.y - sx * r.z, sx * r.y + cx * r.z};
+}
+
+float edge(float ax, float ay, float bx, float by, float px, float py) {
+    return (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+}
+
+}
+
+SoftwareRenderer::SoftwareRenderer(int width, int height) : width_(width), height_(height) {
+    if (width <= 0 || height <= 0) throw std::runtime_error("Invalid render target size");
+    color_.resize(static_cast<std::size_t>(width) * height * 3);
+    depth_.resize(static_cast<std::size_t>(width) * height);
+}
+
+void SoftwareRenderer::setNetwork(const Kohonen3D& net, const PrototypeRenderer& prototypes) {
+    tile_width_ = prototypes.width();
+    tile_height_ = prototypes.height();
+
+    // mismas posiciones que KohonenVisualizer::initNeurons
+    const LatticeShape& lattice = net.getLattice();
+    lattice_size_[0] = net.getSizeX();
+    lattice_size_[1] = net.getSizeY();
+    lattice_size_[2] = net.getSizeZ();
+    positions_.resize(static_cast<std::size_t>(lattice.neurons()) * 3);
+    float lo[3] = {FLT_MAX, FLT_MAX, FLT_MAX}, hi[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (int i = 0; i < lattice.neurons(); i++) {
+        float* p = &positions_[static_cast<std::size_t>(i) * 3];
+        lattice.position(i, p);
+        for (int k = 0; k < 3; k++) {
+            p[k] *= kSpacing;
+            lo[k] = std::min(lo[k], p[k]);
+            hi[k] = std::max(hi[k], p[k]);
+        }
+    }
+    for (std::size_t j = 0; j < positions_.size(); j++) positions_[j] -= 0.5f * (lo[j % 3] + hi[j % 3]);
+
+    std::size_t tile_bytes = static_cast<std::size_t>(tile_width_) * tile_height_ * 3;
+    tiles_.resize(tile_bytes * net.getNumNeurons());
+    for (int i = 0; i < net.getNumNeurons(); i++) {
+        prototypes.render(net.getWeight(i), &tiles_[static_cast<std::size_t>(i) * tile_bytes]);
+    }
+}
+
+const std::vector<unsigned char>& SoftwareRenderer::render(const Camera& camera) {
+    for (std::size_t p = 0; p < color_.size(); p += 3) {
+        std::copy(kBackground, kBackground + 3, &color_[p]);
+    }
+    std::fill(depth_.begin(), depth_.end(), 0.0f);
+
+    float cx = std::cos(camera.angleX * kDegToRad), sx = std::sin(camera.angleX * kDegToRad);
+    float cy = std::cos(camera.angleY * kDegToRad), sy = std::sin(camera.angleY * kDegToRad);
+    float focal = 1.0f / std::tan(camera.fovY * 0.5f * kDegToRad);
+    float aspect = static_cast<float>(width_) / height_;
+    float far_plane = cameraFarPlane(camera.zoom, lattice_size_[0], lattice_size_[1], lattice_size_[2]);
+
+    // ejes del quad en espacio de cámara: iguales para todas las neuronas
+    Vec3 axis_u = rotate({kQuadHalfSize, 0, 0}, cx, sx, cy, sy);
+    Vec3 axis_v = rotate({0, kQuadHalfSize, 0}, cx, sx, cy, sy);
+    static const float kCorners[4][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+
+    std::size_t tile_bytes = static_cast<std::size_t>(tile_width_) * tile_height_ * 3;
+    int neurons = static_cast<int>(positions_.size() / 3);
+    for (int i = 0; i < neurons; i++) {
+        const float* p = &positions_[static_cast<std::size_t>(i) * 3];
+        Vec3 world{p[0], p[1], p[2]};
+        Vec3 center = rotate(world, cx, sx, cy, sy);
+        center.z += camera.zoom;
+
+        ScreenVertex v[4];
+        bool visible = true;
+        for (int k = 0; k < 4 && visible; k++) {
+            float ex = center.x + kCorners[k][0] * axis_u.x + kCorners[k][1] * axis_v.x;
+            float ey = center.y + kCorners[k][0] * axis_u.y + kCorners[k][1] * axis_v.y;
+            float ez = center.z + kCorners[k][0] * axis_u.z + kCorners[k][1] * axis_v.z;
+            float distance = -ez;
+            // sin recorte contra los planos: el quad se descarta entero
+            if (distance < kCameraNear || distance > far_plane) visible = false;
+            float inv = 1.0f / distance;
+            v[k].x = (focal / aspect * ex * inv + 1.0f) * 0.5f * width_;
+            v[k].y = (1.0f - focal * ey * inv) * 0.5f * height_;
+            v[k].invW = inv;
+            v[k].u = (kCorners[k][0] + 1.0f) * 0.5f;
+            v[k].v = (kCorners[k][1] + 1.0f) * 0.5f;
+        }
+        if (!visible) continue;
+
+        const unsigned char* tile = &tiles_[static_cast<std::size_t>(i) * tile_bytes];
+        drawTriangle(v[0], v[1], v[2], tile);
+        drawTriangle(v[0], v[2], v[3], tile);
+    }
+    return color_;
+}
+
+// Rasterizado por funciones de arista con prueba de profundidad sobre 1/w y
+// coordenadas de textura con corrección de perspectiva.
+void SoftwareRenderer::drawTriangle(const ScreenVertex& a, const ScreenVertex& b, const ScreenVertex& c,
+                                    const unsigned char* tile) {
+    float area = edge(a.x, a.y, b.x, b.y, c.x, c.y);
+    if (std::fabs(area) < 1e-8f) return;
+    float inv_area = 1.0f / area;
+
+    int x0 = std::max(0, static_cast<int>(std::floor(std::min({a.x, b.x, c.x}))));
+    int x1 = std::min(width_ - 1, static_cast<int>(std::ceil(std::max({a.x, b.x, c.x}))));
+    int y0 = std::max(0, static_cast<int>(std::floor(std::min({a.y, b.y, c.y}))));
+    int y1 = std::min(height_ - 1, static_cast<int>(std::ceil(std::max({a.y, b.y, c.y}))));
+
+    for (int py = y0; py <= y1; py++) {
+        float fy = py + 0.5f;
+        for (int px = x0; px <= x1; px++) {
+            float fx = px + 0.5f;
+            float w0 = edge(b.x, b.y, c.x, c.y, fx, fy) * inv_area;
+            float w1 = edge(c.x, c.y, a.x, a.y, fx, fy) * inv_area;
+            float w2 = edge(a.x, a.y, b.x, b.y, fx, fy) * inv_area;
+            if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) continue;
+
+            float inv_w = w0 * a.invW + w1 * b.invW + w2 * c.invW;
+            std::size_t pixel = static_cast<std::size_t>(py) * width_ + px;
+            if (inv_w <= depth_[pixel]) continue;
+            depth_[pixel] = inv_w;
+
+            float u = (w0 * a.u * a.invW + w1 * b.u * b.invW + w2 * c.u * c.invW) / inv_w;
+            float v = (w0 * a.v * a.invW + w1 * b.v * b.invW + w2 * c.v * c.invW) / inv_w;
+            sample(tile, u, v, &color_[pixel * 3]);
+        }
+    }
+}
+
+// Filtro bilineal con GL_CLAMP_TO_EDGE; v = 0 es la primera fila de la
+// tesela, como en glTexImage2D.
+void SoftwareRenderer::sample(const unsigned char* tile, float u, float v, unsigned char* out) const {
+    float fx = std::min(std::max(u * tile_width_ - 0.5f, 0.0f), tile_width_ - 1.0f);
+    float fy = std::min(std::max(v * tile_height_ - 0.5f, 0.0f), tile_height_ - 1.0f);
+    int ix = static_cast<int>(fx), iy = static_cast<int>(fy);
+    int ix1 = std::min(ix + 1, tile_width_ - 1), iy1 = std::min(iy + 1, tile_height_ - 1);
+    float tx = fx - ix, ty = fy - iy;
+    const unsigned char* p00 = tile + (iy * tile_width_ + ix) * 3;
+    const unsigned char* p10 = tile + (iy * tile_width_ + ix1) * 3;
+    const unsigned char* p01 = tile + (iy1 * tile_width_ + ix) * 3;
+    const unsigned char* p11 = tile + (iy1 * tile_width_ + ix1) * 3;
+    for (int c = 0; c < 3; c++) {
+        float top = p00[c] + tx * (p10[c] - p00[c]);
+        float bottom = p01[c] + tx * (p11[c] - p01[c]);
+        out[c] = static_cast<unsigned char>(top + ty * (bottom - top) + 0.5f);
+    }
+}
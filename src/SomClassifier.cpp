@@ -0,0 +1,92 @@
+#include "SomClassifier.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+SomClassifier::SomClassifier(const Kohonen3D& net, int classes)
+    : lattice_(net.getLattice()), classes_(classes),
+      labels_(net.getNumNeurons(), -1),
+      probabilities_(static_cast<std::size_t>(net.getNumNeurons()) * classes, 0.0f) {
+    if (classes <= 0 || classes > 256) throw std::runtime_error("Invalid number of classes");
+}
+
+void SomClassifier::fit(const std::vector<MappedSample>& mapped, const std::vector<uint8_t>& labels) {
+    if (mapped.size() != labels.size()) throw std::runtime_error("Number of labels does not match the mapped samples");
+    int neurons = static_cast<int>(labels_.size());
+
+    // 1) histograma de etiquetas por BMU
+    std::vector<int> counts(static_cast<std::size_t>(neurons) * classes_, 0);
+    for (std::size_t s = 0; s < mapped.size(); s++) {
+        if (labels[s] >= classes_) throw std::runtime_error("Label out of range");
+        counts[static_cast<std::size_t>(mapped[s].bmu) * classes_ + labels[s]]++;
+    }
+
+    std::fill(probabilities_.begin(), probabilities_.end(), 0.0f);
+    std::vector<char> known(neurons, 0);
+    for (int i = 0; i < neurons; i++) {
+        const int* c = &counts[static_cast<std::size_t>(i) * classes_];
+        int total = 0;
+        for (int k = 0; k < classes_; k++) total += c[k];
+        if (total == 0) continue;
+        float* p = &probabilities_[static_cast<std::size_t>(i) * classes_];
+        for (int k = 0; k < classes_; k++) p[k] = static_cast<float>(c[k]) / total;
+        known[i] = 1;
+    }
+
+    // 2) relleno por capas de las neuronas sin muestras; cada capa sólo usa
+    // neuronas de capas anteriores, así que el resultado no depende del orden
+    std::vector<int> frontier;
+    std::vector<float> mean(classes_);
+    bool any_known = std::find(known.begin(), known.end(), 1) != known.end();
+    while (any_known) {
+        frontier.clear();
+        for (int i = 0; i < neurons; i++) {
+            if (known[i]) continue;
+            std::fill(mean.begin(), mean.end(), 0.0f);
+            int found = 0;
+            lattice_.forEachAdjacent(i, [&](int n) {
+                if (known[n] != 1) return;
+                const float* p = &probabilities_[static_cast<std::size_t>(n) * classes_];
+                for (int k = 0; k < classes_; k++) mean[k] += p[k];
+                found++;
+            });
+            if (found == 0) continue;
+            float* p = &probabilities_[static_cast<std::size_t>(i) * classes_];
+            for (int k = 0; k < classes_; k++) p[k] = mean[k] / found;
+            frontier.push_back(i);
+        }
+        if (frontier.empty()) break;
+        for (int i : frontier) known[i] = 1;
+    }
+
+    // 3) etiqueta mayoritaria (en empate, la clase menor)
+    for (int i = 0; i < neurons; i++) {
+        if (!known[i]) {
+            labels_[i] = -1;
+            continue;
+        }
+        const float* p = &probabilities_[static_cast<std::size_t>(i) * classes_];
+        labels_[i] = static_cast<int>(std::max_element(p, p + classes_) - p);
+    }
+}
+
+std::vector<uint8_t> SomClassifier::predict(const std::vector<MappedSample>& mapped) const {
+    std::vector<uint8_t> predictions(mapped.size());
+    for (std::size_t s = 0; s < mapped.size(); s++) predictions[s] = predict(mapped[s]);
+    return predictions;
+}
+
+ClassificationReport SomClassifier::evaluate(const std::vector<MappedSample>& mapped,
+                                             const std::vector<uint8_t>& labels) const {
+    if (mapped.size() != labels.size()) throw std::runtime_error("Number of labels does not match the mapped samples");
+    ClassificationReport report;
+    report.samples = static_cast<int>(mapped.size());
+    report.confusion.assign(static_cast<std::size_t>(classes_) * classes_, 0);
+    for (std::size_t s = 0; s < mapped.size(); s++) {
+        int predicted = labels_[mapped[s].bmu];
+        if (predicted < 0 || labels[s] >= classes_) continue;
+        report.confusion[static_cast<std::size_t>(labels[s]) * classes_ + predicted]++;
+        if (predicted == labels[s]) report.correct++;
+    }
+    report.accuracy = report.samples > 0 ? static_cast<float>(report.correct) / report.samples : 0.0f;
+    return report;
+}
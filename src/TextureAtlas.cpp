@@ -0,0 +1,55 @@
+#include "TextureAtlas.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+TextureAtlas::TextureAtlas(int tileWidth, int tileHeight, int tileCount, int maxPageSize, int padding)
+    : tileWidth_(tileWidth), tileHeight_(tileHeight), padding_(std::max(0, padding)) {
+    if (tileWidth <= 0 || tileHeight <= 0 || slotWidth() > maxPageSize || slotHeight() > maxPageSize) {
+        throw std::runtime_error("Atlas tile does not fit in a texture page");
+    }
+    if (tileCount <= 0) return;
+
+    // rejilla lo más cuadrada posible, recortada al tamaño máximo de página
+    int side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(tileCount))));
+    columns_ = std::min(side, maxPageSize / slotWidth());
+    rows_ = std::min((tileCount + columns_ - 1) / columns_, maxPageSize / slotHeight());
+
+    int per_page = columns_ * rows_;
+    int page_count = (tileCount + per_page - 1) / per_page;
+    std::size_t page_bytes = static_cast<std::size_t>(pageWidth()) * pageHeight() * 3;
+    pages_.assign(page_count, std::vector<unsigned char>(page_bytes, 0));
+
+    float width = static_cast<float>(pageWidth());
+    float height = static_cast<float>(pageHeight());
+    tiles_.resize(tileCount);
+    for (int i = 0; i < tileCount; i++) {
+        int slot = i % per_page;
+        AtlasTile& t = tiles_[i];
+        t.page = i / per_page;
+        t.x = (slot % columns_) * slotWidth() + padding_;
+        t.y = (slot / columns_) * slotHeight() + padding_;
+        t.u0 = t.x / width;
+        t.v0 = t.y / height;
+        t.u1 = (t.x + tileWidth_) / width;
+        t.v1 = (t.y + tileHeight_) / height;
+    }
+}
+
+void TextureAtlas::setTile(int index, const unsigned char* rgb) {
+    const AtlasTile& t = tiles_[index];
+    std::size_t row_bytes = static_cast<std::size_t>(tileWidth_) * 3;
+    std::size_t page_stride = static_cast<std::size_t>(pageWidth()) * 3;
+    unsigned char* page = pages_[t.page].data();
+    for (int r = -padding_; r < tileHeight_ + padding_; r++) {
+        int src_row = std::min(std::max(r, 0), tileHeight_ - 1);
+        const unsigned char* src = rgb + src_row * row_bytes;
+        unsigned char* dst = page + (t.y + r) * page_stride + t.x * 3;
+        std::memcpy(dst, src, row_bytes);
+        for (int c = 1; c <= padding_; c++) {
+            std::memcpy(dst - c * 3, src, 3);
+            std::memcpy(dst + row_bytes + (c - 1) * 3, src + row_bytes - 3, 3);
+        }
+    }
+}
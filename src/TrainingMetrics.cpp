@@ -0,0 +1,60 @@
+#include "TrainingMetrics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+TrainingMetrics::TrainingMetrics(int neurons) : hits_(neurons, 0) {}
+
+void TrainingMetrics::reset() {
+    samples_ = 0;
+    error_sum_ = 0.0;
+    topo_samples_ = 0;
+    topo_errors_ = 0;
+    std::fill(hits_.begin(), hits_.end(), 0);
+}
+
+void TrainingMetrics::add(int bmu, float distance, bool second_known, bool second_adjacent) {
+    samples_++;
+    error_sum_ += std::sqrt(distance);
+    hits_[bmu]++;
+    if (second_known) {
+        topo_samples_++;
+        if (!second_adjacent) topo_errors_++;
+    }
+}
+
+void TrainingMetrics::merge(const TrainingMetrics& other) {
+    samples_ += other.samples_;
+    error_sum_ += other.error_sum_;
+    topo_samples_ += other.topo_samples_;
+    topo_errors_ += other.topo_errors_;
+    for (std::size_t i = 0; i < hits_.size(); i++) hits_[i] += other.hits_[i];
+}
+
+std::vector<double> TrainingMetrics::pack() const {
+    std::vector<double> packed = {static_cast<double>(samples_), error_sum_, static_cast<double>(topo_samples_),
+                                  static_cast<double>(topo_errors_)};
+    packed.insert(packed.end(), hits_.begin(), hits_.end());
+    return packed;
+}
+
+void TrainingMetrics::unpack(const std::vector<double>& packed) {
+    if (packed.size() != hits_.size() + 4) throw std::runtime_error("Packed metrics do not match the network");
+    samples_ = static_cast<long long>(packed[0]);
+    error_sum_ = packed[1];
+    topo_samples_ = static_cast<long long>(packed[2]);
+    topo_errors_ = static_cast<long long>(packed[3]);
+    for (std::size_t i = 0; i < hits_.size(); i++) hits_[i] = static_cast<int>(packed[i + 4]);
+}
+
+double TrainingMetrics::quantizationError() const {
+    return samples_ > 0 ? error_sum_ / samples_ : 0.0;
+}
+
+double TrainingMetrics::topographicError() const {
+    return topo_samples_ > 0 ? static_cast<double>(topo_errors_) / topo_samples_ : -1.0;
+}
+
+int TrainingMetrics::deadNeurons() const {
+    return static_cast<int>(std::count(hits_.begin(), hits_.end(), 0));
+}
@@ -0,0 +1,122 @@
+#include "TrainingSchedule.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+Decay Decay::linear(float initial, float final_value) {
+    Decay decay;
+    decay.kind_ = Kind::Linear;
+    decay.a_ = initial;
+    decay.b_ = final_value;
+    return decay;
+}
+
+Decay Decay::exponential(float initial, float final_value) {
+    if (initial <= 0.0f || final_value <= 0.0f) throw std::runtime_error("Exponential decay needs positive values");
+    Decay decay;
+    decay.kind_ = Kind::Exponential;
+    decay.a_ = initial;
+    decay.b_ = final_value;
+    return decay;
+}
+
+Decay Decay::inverseTime(float initial, float rate) {
+    if (rate <= -1.0f) throw std::runtime_error("Inverse-time decay rate must be greater than -1");
+    Decay decay;
+    decay.kind_ = Kind::InverseTime;
+    decay.a_ = initial;
+    decay.b_ = rate;
+    return decay;
+}
+
+Decay Decay::piecewise(std::vector<std::pair<float, float>> points) {
+    if (points.empty()) throw std::runtime_error("Piecewise decay needs at least one point");
+    for (std::size_t i = 1; i < points.size(); i++) {
+        if (points[i].first < points[i - 1].first) throw std::runtime_error("Piecewise decay points must be sorted by t");
+    }
+    Decay decay;
+    decay.kind_ = Kind::Piecewise;
+    decay.points_ = std::move(points);
+    return decay;
+}
+
+float Decay::at(float t) const {
+    switch (kind_) {
+        case Kind::Linear:
+            // misma expresión que el calendario original cuando b_ = 0
+            return a_ * (1.0f - t) + b_ * t;
+        case Kind::Exponential:
+            return a_ * std::pow(b_ / a_, t);
+        case Kind::InverseTime:
+            return a_ / (1.0f + b_ * t);
+        case Kind::Piecewise: {
+            if (t <= points_.front().first) return points_.front().second;
+            if (t >= points_.back().first) return points_.back().second;
+            auto next = std::upper_bound(points_.begin(), points_.end(), t,
+                                         [](float value, const std::pair<float, float>& p) { return value < p.first; });
+            auto prev = next - 1;
+            float span = next->first - prev->first;
+            float u = span > 0.0f ? (t - prev->first) / span : 1.0f;
+            return prev->second + u * (next->second - prev->second);
+        }
+    }
+    return 0.0f;
+}
+
+TrainingSchedule TrainingSchedule::linear(float learning_rate, float radius) {
+    TrainingSchedule schedule;
+    schedule.learningRate = Decay::linear(learning_rate);
+    schedule.radius = Decay::linear(radius);
+    return schedule;
+}
+
+ScheduleTable::ScheduleTable(const TrainingSchedule& schedule, int epochs, long long samples_per_epoch,
+                             const LatticeShape& lattice)
+    : per_sample_(schedule.granularity == ScheduleGranularity::Sample),
+      epochs_(epochs), samples_per_epoch_(samples_per_epoch), lattice_(lattice) {
+    if (epochs <= 0) throw std::runtime_error("The number of epochs must be positive");
+    if (per_sample_ && samples_per_epoch <= 0) {
+        throw std::runtime_error("Per-sample schedules need the number of samples per epoch");
+    }
+
+    total_samples_ = per_sample_ ? epochs * samples_per_epoch : epochs;
+    steps_ = per_sample_ ? static_cast<int>(std::min<long long>(total_samples_, kMaxSampleSteps)) : epochs;
+    learning_rate_.resize(steps_);
+    stencil_of_.resize(steps_);
+
+    for (int s = 0; s < steps_; s++) {
+        float t = per_sample_ ? static_cast<float>(stepStart(s)) / total_samples_ : static_cast<float>(s) / epochs;
+        learning_rate_[s] = schedule.learningRate.at(t);
+
+        float radius = schedule.radius.at(t);
+        if (per_sample_) radius = std::round(radius / kRadiusQuantum) * kRadiusQuantum;
+        // los radios que se repiten suelen ser consecutivos (curvas monótonas)
+        int found = -1;
+        for (int k = static_cast<int>(stencils_.size()) - 1; k >= 0 && found < 0; k--) {
+            if (stencils_[k].radius() == radius) found = k;
+        }
+        if (found < 0) {
+            found = static_cast<int>(stencils_.size());
+            stencils_.emplace_back(radius, lattice);
+        }
+        stencil_of_[s] = found;
+    }
+}
+
+long long ScheduleTable::stepStart(int step) const {
+    if (!per_sample_) return static_cast<long long>(step) * samples_per_epoch_;
+    return static_cast<long long>(static_cast<double>(step) * total_samples_ / steps_);
+}
+
+int ScheduleTable::stepForSample(long long sample) const {
+    if (!per_sample_) return std::min(steps_ - 1, static_cast<int>(sample / std::max(1LL, samples_per_epoch_)));
+    int step = static_cast<int>(std::min<long long>(steps_ - 1, static_cast<long long>(static_cast<double>(sample) * steps_ / total_samples_)));
+    while (step + 1 < steps_ && stepStart(step + 1) <= sample) step++;
+    while (step > 0 && stepStart(step) > sample) step--;
+    return step;
+}
+
+int ScheduleTable::stepForEpoch(int epoch) const {
+    if (!per_sample_) return std::min(epoch, steps_ - 1);
+    return stepForSample(static_cast<long long>(epoch) * samples_per_epoch_);
+}
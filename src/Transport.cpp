@@ -0,0 +1,274 @@
+#include "Transport.hpp"
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+std::string socketPath(const std::string& prefix, int rank) {
+    return prefix + "." + std::to_string(rank);
+}
+
+sockaddr_un socketAddress(const std::string& path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) throw std::runtime_error("Socket path too long: " + path);
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return addr;
+}
+
+// Espera a que fd admita events; timeout_ms < 0 espera sin límite.
+void waitReady(int fd, short events, int timeout_ms) {
+    for (;;) {
+        pollfd pfd{fd, events, 0};
+        int ready = ::poll(&pfd, 1, timeout_ms);
+        if (ready > 0) return;
+        if (ready == 0) throw std::runtime_error("Timed out waiting for a transport peer");
+        if (errno != EINTR) throw std::runtime_error(std::string("Transport poll failed: ") + std::strerror(errno));
+    }
+}
+
+bool wouldBlock() {
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+}
+
+void writeAll(int fd, const void* data, std::size_t bytes, int timeout_ms) {
+    const char* p = static_cast<const char*>(data);
+    while (bytes > 0) {
+        waitReady(fd, POLLOUT, timeout_ms);
+        ssize_t n = ::send(fd, p, bytes, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n < 0) {
+            if (wouldBlock()) continue;
+            throw std::runtime_error(std::string("Transport send failed: ") + std::strerror(errno));
+        }
+        p += n;
+        bytes -= static_cast<std::size_t>(n);
+    }
+}
+
+void readAll(int fd, void* data, std::size_t bytes, int timeout_ms) {
+    char* p = static_cast<char*>(data);
+    while (bytes > 0) {
+        waitReady(fd, POLLIN, timeout_ms);
+        ssize_t n = ::recv(fd, p, bytes, MSG_DONTWAIT);
+        if (n == 0) throw std::runtime_error("Transport peer closed the connection");
+        if (n < 0) {
+            if (wouldBlock()) continue;
+            throw std::runtime_error(std::string("Transport receive failed: ") + std::strerror(errno));
+        }
+        p += n;
+        bytes -= static_cast<std::size_t>(n);
+    }
+}
+
+// Trozo c de N de un vector de count elementos.
+std::size_t chunkBegin(std::size_t count, int chunk, int chunks) {
+    return count * static_cast<std::size_t>(chunk) / static_cast<std::size_t>(chunks);
+}
+
+template <typename T>
+void ringAllreduceImpl(Transport& transport, T* data, std::size_t count) {
+    int n = transport.size();
+    if (n == 1 || count == 0) return;
+    int rank = transport.rank();
+    int next = (rank + 1) % n;
+    int prev = (rank + n - 1) % n;
+    std::vector<T> incoming(count / n + 1);
+
+    // reduce-scatter: tras N-1 pasos el proceso r tiene completo el trozo r+1
+    for (int step = 0; step < n - 1; step++) {
+        int send_chunk = ((rank - step) % n + n) % n;
+        int recv_chunk = ((rank - step - 1) % n + n) % n;
+        std::size_t sb = chunkBegin(count, send_chunk, n), se = chunkBegin(count, send_chunk + 1, n);
+        std::size_t rb = chunkBegin(count, recv_chunk, n), re = chunkBegin(count, recv_chunk + 1, n);
+        transport.sendRecv(next, data + sb, (se - sb) * sizeof(T), prev, incoming.data(), (re - rb) * sizeof(T));
+        for (std::size_t i = rb; i < re; i++) data[i] += incoming[i - rb];
+    }
+    // allgather: los trozos completos dan la vuelta al anillo
+    for (int step = 0; step < n - 1; step++) {
+        int send_chunk = ((rank + 1 - step) % n + n) % n;
+        int recv_chunk = ((rank - step) % n + n) % n;
+        std::size_t sb = chunkBegin(count, send_chunk, n), se = chunkBegin(count, send_chunk + 1, n);
+        std::size_t rb = chunkBegin(count, recv_chunk, n), re = chunkBegin(count, recv_chunk + 1, n);
+        transport.sendRecv(next, data + sb, (se - sb) * sizeof(T), prev, data + rb, (re - rb) * sizeof(T));
+    }
+}
+
+}
+
+UnixSocketTransport::UnixSocketTransport(const std::string& prefix, int rank, int size, int timeout_ms,
+                                         int io_timeout_ms)
+    : rank_(rank), size_(size), io_timeout_ms_(io_timeout_ms), peers_(size > 0 ? size : 0, -1) {
+    if (size < 1 || rank < 0 || rank >= size) throw std::runtime_error("Invalid transport rank or size");
+    if (size == 1) return;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    auto closeAll = [this] {
+        for (int& fd : peers_) {
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+        }
+        if (listen_fd_ >= 0) {
+            ::close(listen_fd_);
+            ::unlink(path_.c_str());
+            listen_fd_ = -1;
+        }
+    };
+
+    try {
+        path_ = socketPath(prefix, rank);
+        sockaddr_un addr = socketAddress(path_);
+        listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listen_fd_ < 0) throw std::runtime_error(std::string("Cannot create socket: ") + std::strerror(errno));
+        ::unlink(path_.c_str());   // restos de una ejecución anterior
+        if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(listen_fd_, size) != 0) {
+            throw std::runtime_error("Cannot listen on " + path_ + " (" + std::strerror(errno) + ")");
+        }
+
+        // a los de rango menor: reintentar hasta que su socket exista
+        for (int peer = 0; peer < rank; peer++) {
+            sockaddr_un peer_addr = socketAddress(socketPath(prefix, peer));
+            for (;;) {
+                int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+                if (fd < 0) throw std::runtime_error(std::string("Cannot create socket: ") + std::strerror(errno));
+                if (::connect(fd, reinterpret_cast<sockaddr*>(&peer_addr), sizeof(peer_addr)) == 0) {
+                    peers_[peer] = fd;
+                    break;
+                }
+                ::close(fd);
+                if (std::chrono::steady_clock::now() > deadline) {
+                    throw std::runtime_error("Timed out connecting to transport rank " + std::to_string(peer));
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            int32_t me = rank;
+            writeAll(peers_[peer], &me, sizeof(me), timeout_ms);
+        }
+
+        // los de rango mayor se presentan con su rango
+        for (int pending = size - 1 - rank; pending > 0; pending--) {
+            pollfd pfd{listen_fd_, POLLIN, 0};
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            int ready = left.count() > 0 ? ::poll(&pfd, 1, static_cast<int>(left.count())) : 0;
+            if (ready < 0 && errno == EINTR) {
+                pending++;
+                continue;
+            }
+            if (ready <= 0) throw std::runtime_error("Timed out waiting for transport peers");
+            int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd < 0) throw std::runtime_error(std::string("Cannot accept transport peer: ") + std::strerror(errno));
+            int32_t peer = -1;
+            try {
+                readAll(fd, &peer, sizeof(peer), timeout_ms);
+            } catch (...) {
+                ::close(fd);
+                throw;
+            }
+            if (peer <= rank || peer >= size || peers_[peer] >= 0) {
+                ::close(fd);
+                throw std::runtime_error("Unexpected transport peer rank " + std::to_string(peer));
+            }
+            peers_[peer] = fd;
+        }
+    } catch (...) {
+        closeAll();
+        throw;
+    }
+
+    // todos conectados: el socket de escucha ya no hace falta
+    ::close(listen_fd_);
+    ::unlink(path_.c_str());
+    listen_fd_ = -1;
+}
+
+UnixSocketTransport::~UnixSocketTransport() {
+    for (int fd : peers_) {
+        if (fd >= 0) ::close(fd);
+    }
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        ::unlink(path_.c_str());
+    }
+}
+
+int UnixSocketTransport::peerSocket(int peer) const {
+    if (peer < 0 || peer >= size_ || peer == rank_) throw std::runtime_error("Invalid transport peer " + std::to_string(peer));
+    return peers_[peer];
+}
+
+void UnixSocketTransport::send(int peer, const void* data, std::size_t bytes) {
+    writeAll(peerSocket(peer), data, bytes, io_timeout_ms_);
+}
+
+void UnixSocketTransport::recv(int peer, void* data, std::size_t bytes) {
+    readAll(peerSocket(peer), data, bytes, io_timeout_ms_);
+}
+
+void UnixSocketTransport::sendRecv(int to, const void* send_data, std::size_t send_bytes,
+                                   int from, void* recv_data, std::size_t recv_bytes) {
+    int to_fd = peerSocket(to);
+    int from_fd = peerSocket(from);
+    const char* out = static_cast<const char*>(send_data);
+    char* in = static_cast<char*>(recv_data);
+    std::size_t sent = 0, received = 0;
+    while (sent < send_bytes || received < recv_bytes) {
+        pollfd fds[2];
+        int count = 0;
+        int send_slot = -1, recv_slot = -1;
+        if (sent < send_bytes) {
+            send_slot = count;
+            fds[count++] = {to_fd, POLLOUT, 0};
+        }
+        if (received < recv_bytes) {
+            recv_slot = count;
+            fds[count++] = {from_fd, POLLIN, 0};
+        }
+        // el plazo cuenta desde el último byte movido en cualquier sentido
+        int ready = ::poll(fds, count, io_timeout_ms_);
+        if (ready == 0) throw std::runtime_error("Timed out waiting for a transport peer");
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(std::string("Transport poll failed: ") + std::strerror(errno));
+        }
+
+        if (send_slot >= 0 && fds[send_slot].revents) {
+            ssize_t n = ::send(to_fd, out + sent, send_bytes - sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (n > 0) sent += static_cast<std::size_t>(n);
+            else if (n < 0 && !wouldBlock()) {
+                throw std::runtime_error(std::string("Transport send failed: ") + std::strerror(errno));
+            }
+        }
+        if (recv_slot >= 0 && fds[recv_slot].revents) {
+            ssize_t n = ::recv(from_fd, in + received, recv_bytes - received, MSG_DONTWAIT);
+            if (n == 0) throw std::runtime_error("Transport peer closed the connection");
+            if (n > 0) received += static_cast<std::size_t>(n);
+            else if (!wouldBlock()) {
+                throw std::runtime_error(std::string("Transport receive failed: ") + std::strerror(errno));
+            }
+        }
+    }
+}
+
+void ringAllreduce(Transport& transport, float* data, std::size_t count) {
+    ringAllreduceImpl(transport, data, count);
+}
+
+void ringAllreduce(Transport& transport, double* data, std::size_t count) {
+    ringAllreduceImpl(transport, data, count);
+}
+
+void broadcast(Transport& transport, void* data, std::size_t bytes, int root) {
+    int n = transport.size();
+    if (n == 1) return;
+    int rank = transport.rank();
+    int relative = (rank - root + n) % n;
+    if (relative != 0) transport.recv((rank + n - 1) % n, data, bytes);
+    if (relative != n - 1) transport.send((rank + 1) % n, data, bytes);
+}
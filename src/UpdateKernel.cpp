@@ -0,0 +1,258 @@
+#include "UpdateKernel.hpp"
+#include <cfloat>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define KOHONEN_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Todas las variantes suponen neuronas distintas en la lista (las que da un
+// stencil): las filas de un bloque se leen antes de escribir ninguna.
+
+template <bool Score>
+BMUResult updateScalarT(float* weights, int stride, int cols, const NeighborUpdate* updates, int count,
+                        const float* input, const float* next) {
+    BMUResult best{count > 0 ? updates[0].neuron : -1, FLT_MAX};
+    for (int k = 0; k < count; k++) {
+        float* w = weights + static_cast<std::size_t>(updates[k].neuron) * stride;
+        float alpha = updates[k].alpha;
+        float beta = 1.0f - alpha;
+        float dist = 0.0f;
+        for (int j = 0; j < cols; j++) {
+            w[j] = w[j] * beta + alpha * input[j];
+            if (Score) dist += (next[j] - w[j]) * (next[j] - w[j]);
+        }
+        if (Score) best.consider(updates[k].neuron, dist);
+    }
+    return best;
+}
+
+BMUResult updateScalar(float* weights, int stride, int cols, const NeighborUpdate* updates, int count,
+                       const float* input, const float* next) {
+    if (next) return updateScalarT<true>(weights, stride, cols, updates, count, input, next);
+    return updateScalarT<false>(weights, stride, cols, updates, count, input, next);
+}
+
+#ifdef KOHONEN_X86
+
+// Rows filas a la vez: cada trozo de la entrada (y de la muestra siguiente)
+// se carga una vez para todo el bloque. Las columnas que no llenan un
+// registro se tratan en escalar (o con máscara en AVX-512), así que el
+// relleno de las filas nunca se escribe.
+
+template <int Rows, bool Score>
+void updateRowsSSE(float* weights, int stride, int cols, const NeighborUpdate* updates,
+                   const float* input, const float* next, BMUResult& best) {
+    float* w[Rows];
+    __m128 alpha[Rows], beta[Rows], acc[Rows];
+    for (int r = 0; r < Rows; r++) {
+        w[r] = weights + static_cast<std::size_t>(updates[r].neuron) * stride;
+        alpha[r] = _mm_set1_ps(updates[r].alpha);
+        beta[r] = _mm_set1_ps(1.0f - updates[r].alpha);
+        acc[r] = _mm_setzero_ps();
+    }
+    int vec_cols = cols & ~3;
+    int j = 0;
+    for (; j < vec_cols; j += 4) {
+        __m128 x = _mm_loadu_ps(input + j);
+        __m128 n = Score ? _mm_loadu_ps(next + j) : x;
+#pragma GCC unroll 4
+        for (int r = 0; r < Rows; r++) {
+            __m128 v = _mm_add_ps(_mm_mul_ps(_mm_load_ps(w[r] + j), beta[r]), _mm_mul_ps(alpha[r], x));
+            _mm_store_ps(w[r] + j, v);
+            if (Score) {
+                __m128 d = _mm_sub_ps(n, v);
+                acc[r] = _mm_add_ps(acc[r], _mm_mul_ps(d, d));
+            }
+        }
+    }
+    for (int r = 0; r < Rows; r++) {
+        float a = updates[r].alpha, b = 1.0f - a;
+        float dist = 0.0f;
+        if (Score) {
+            alignas(16) float lanes[4];
+            _mm_store_ps(lanes, acc[r]);
+            dist = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        }
+        for (int t = j; t < cols; t++) {
+            w[r][t] = w[r][t] * b + a * input[t];
+            if (Score) dist += (next[t] - w[r][t]) * (next[t] - w[r][t]);
+        }
+        if (Score) best.consider(updates[r].neuron, dist);
+    }
+}
+
+template <bool Score>
+BMUResult updateSSET(float* weights, int stride, int cols, const NeighborUpdate* updates, int count,
+                     const float* input, const float* next) {
+    BMUResult best{count > 0 ? updates[0].neuron : -1, FLT_MAX};
+    int k = 0;
+    for (; k + 4 <= count; k += 4) updateRowsSSE<4, Score>(weights, stride, cols, updates + k, input, next, best);
+    for (; k < count; k++) updateRowsSSE<1, Score>(weights, stride, cols, updates + k, input, next, best);
+    return best;
+}
+
+BMUResult updateSSE(float* weights, int stride, int cols, const NeighborUpdate* updates, int count,
+                    const float* input, const float* next) {
+    if (next) return updateSSET<true>(weights, stride, cols, updates, count, input, next);
+    return updateSSET<false>(weights, stride, cols, updates, count, input, next);
+}
+
+template <int Rows, bool Score>
+__attribute__((target("avx2,fma")))
+void updateRowsAVX2(float* weights, int stride, int cols, const NeighborUpdate* updates,
+                    const float* input, const float* next, BMUResult& best) {
+    float* w[Rows];
+    __m256 alpha[Rows], beta[Rows], acc[Rows];
+    for (int r = 0; r < Rows; r++) {
+        w[r] = weights + static_cast<std::size_t>(updates[r].neuron) * stride;
+        alpha[r] = _mm256_set1_ps(updates[r].alpha);
+        beta[r] = _mm256_set1_ps(1.0f - updates[r].alpha);
+        acc[r] = _mm256_setzero_ps();
+    }
+    int vec_cols = cols & ~7;
+    int j = 0;
+    for (; j < vec_cols; j += 8) {
+        __m256 x = _mm256_loadu_ps(input + j);
+        __m256 n = Score ? _mm256_loadu_ps(next + j) : x;
+#pragma GCC unroll 4
+        for (int r = 0; r < Rows; r++) {
+            __m256 v = _mm256_fmadd_ps(_mm256_load_ps(w[r] + j), beta[r], _mm256_mul_ps(alpha[r], x));
+            _mm256_store_ps(w[r] + j, v);
+            if (Score) {
+                __m256 d = _mm256_sub_ps(n, v);
+                acc[r] = _mm256_fmadd_ps(d, d, acc[r]);
+            }
+        }
+    }
+    for (int r = 0; r < Rows; r++) {
+        float a = updates[r].alpha, b = 1.0f - a;
+        float dist = 0.0f;
+        if (Score) {
+            __m128 s = _mm_add_ps(_mm256_castps256_ps128(acc[r]), _mm256_extractf128_ps(acc[r], 1));
+            s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+            s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+            dist = _mm_cvtss_f32(s);
+        }
+        // misma operación que en los registros: una FMA por componente
+        for (int t = j; t < cols; t++) {
+            _mm_store_ss(w[r] + t, _mm_fmadd_ss(_mm_load_ss(w[r] + t), _mm_set_ss(b), _mm_set_ss(a * input[t])));
+            if (Score) dist += (next[t] - w[r][t]) * (next[t] - w[r][t]);
+        }
+        if (Score) best.consider(updates[r].neuron, dist);
+    }
+}
+
+template <bool Score>
+__attribute__((target("avx2,fma")))
+BMUResult updateAVX2T(float* weights, int stride, int cols, const NeighborUpdate* updates, int count,
+                      const float* input, const float* next) {
+    BMUResult best{count > 0 ? updates[0].neuron : -1, FLT_MAX};
+    int k = 0;
+    for (; k + 4 <= count; k += 4) updateRowsAVX2<4, Score>(weights, stride, cols, updates + k, input, next, best);
+    for (; k < count; k++) updateRowsAVX2<1, Score>(weights, stride, cols, updates + k, input, next, best);
+    return best;
+}
+
+__attribute__((target("avx2,fma")))
+BMUResult updateAVX2(float* weights, int stride, int cols, const NeighborUpdate* updates, int count,
+                     const float* input, const float* next) {
+    if (next) return updateAVX2T<true>(weights, stride, cols, updates, count, input, next);
+    return updateAVX2T<false>(weights, stride, cols, updates, count, input, next);
+}
+
+template <int Rows, bool Score>
+__attribute__((target("avx512f")))
+void updateRowsAVX512(float* weights, int stride, int cols, const NeighborUpdate* updates,
+                      const float* input, const float* next, BMUResult& best) {
+    float* w[Rows];
+    __m512 alpha[Rows], beta[Rows], acc[Rows];
+    for (int r = 0; r < Rows; r++) {
+        w[r] = weights + static_cast<std::size_t>(updates[r].neuron) * stride;
+        alpha[r] = _mm512_set1_ps(updates[r].alpha);
+        beta[r] = _mm512_set1_ps(1.0f - updates[r].alpha);
+        acc[r] = _mm512_setzero_ps();
+    }
+    int vec_cols = cols & ~15;
+    __mmask16 tail = static_cast<__mmask16>((1u << (cols - vec_cols)) - 1);
+    int j = 0;
+    for (; j < vec_cols; j += 16) {
+        __m512 x = _mm512_loadu_ps(input + j);
+        __m512 n = Score ? _mm512_loadu_ps(next + j) : x;
+#pragma GCC unroll 4
+        for (int r = 0; r < Rows; r++) {
+            __m512 v = _mm512_fmadd_ps(_mm512_load_ps(w[r] + j), beta[r], _mm512_mul_ps(alpha[r], x));
+            _mm512_store_ps(w[r] + j, v);
+            if (Score) {
+                __m512 d = _mm512_sub_ps(n, v);
+                acc[r] = _mm512_fmadd_ps(d, d, acc[r]);
+            }
+        }
+    }
+    if (tail) {
+        __m512 x = _mm512_maskz_loadu_ps(tail, input + j);
+        __m512 n = Score ? _mm512_maskz_loadu_ps(tail, next + j) : x;
+#pragma GCC unroll 4
+        for (int r = 0; r < Rows; r++) {
+            __m512 v = _mm512_fmadd_ps(_mm512_maskz_load_ps(tail, w[r] + j), beta[r], _mm512_mul_ps(alpha[r], x));
+            _mm512_mask_store_ps(w[r] + j, tail, v);
+            if (Score) {
+                __m512 d = _mm512_sub_ps(n, v);
+                acc[r] = _mm512_fmadd_ps(d, d, acc[r]);
+            }
+        }
+    }
+    if (Score) {
+        for (int r = 0; r < Rows; r++) best.consider(updates[r].neuron, _mm512_reduce_add_ps(acc[r]));
+    }
+}
+
+template <bool Score>
+__attribute__((target("avx512f")))
+BMUResult updateAVX512T(float* weights, int stride, int cols, const NeighborUpdate* updates, int count,
+                        const float* input, const float* next) {
+    BMUResult best{count > 0 ? updates[0].neuron : -1, FLT_MAX};
+    int k = 0;
+    for (; k + 4 <= count; k += 4) updateRowsAVX512<4, Score>(weights, stride, cols, updates + k, input, next, best);
+    for (; k < count; k++) updateRowsAVX512<1, Score>(weights, stride, cols, updates + k, input, next, best);
+    return best;
+}
+
+__attribute__((target("avx512f")))
+BMUResult updateAVX512(float* weights, int stride, int cols, const NeighborUpdate* updates, int count,
+                       const float* input, const float* next) {
+    if (next) return updateAVX512T<true>(weights, stride, cols, updates, count, input, next);
+    return updateAVX512T<false>(weights, stride, cols, updates, count, input, next);
+}
+
+#endif
+
+}
+
+UpdateKernel::UpdateKernel() : UpdateKernel(BMUSearch::detectSimdLevel()) {}
+
+UpdateKernel::UpdateKernel(SimdLevel level) : level_(level), kernel_(updateScalar) {
+    if (level_ > BMUSearch::detectSimdLevel()) level_ = BMUSearch::detectSimdLevel();
+#ifdef KOHONEN_X86
+    switch (level_) {
+        case SimdLevel::Scalar: kernel_ = updateScalar; break;
+        case SimdLevel::SSE: kernel_ = updateSSE; break;
+        case SimdLevel::AVX2: kernel_ = updateAVX2; break;
+        case SimdLevel::AVX512: kernel_ = updateAVX512; break;
+    }
+#else
+    level_ = SimdLevel::Scalar;
+#endif
+}
+
+void UpdateKernel::apply(WeightMatrix& codebook, const float* input, const NeighborUpdate* updates, int count) const {
+    kernel_(codebook.data(), codebook.stride(), codebook.cols(), updates, count, input, nullptr);
+}
+
+BMUResult UpdateKernel::applyAndScore(WeightMatrix& codebook, const float* input, const NeighborUpdate* updates,
+                                      int count, const float* next) const {
+    return kernel_(codebook.data(), codebook.stride(), codebook.cols(), updates, count, input, next);
+}
@@ -0,0 +1,39 @@
+#include "WeightMatrix.hpp"
+#include <cstring>
+#include <utility>
+
+int WeightMatrix::paddedStride(int cols) {
+    return (cols + kRowAlignment - 1) / kRowAlignment * kRowAlignment;
+}
+
+WeightMatrix::WeightMatrix(int rows, int cols)
+    : rows_(rows), cols_(cols), stride_(paddedStride(cols)),
+      storage_(static_cast<std::size_t>(rows) * paddedStride(cols)) {
+    ptr_ = storage_.data();
+}
+
+// Copiar siempre produce una matriz propia, aunque el origen sea externo.
+WeightMatrix::WeightMatrix(const WeightMatrix& other)
+    : rows_(other.rows_), cols_(other.cols_), stride_(other.stride_),
+      storage_(static_cast<std::size_t>(other.rows_) * other.stride_) {
+    ptr_ = storage_.data();
+    if (ptr_) std::memcpy(ptr_, other.ptr_, sizeBytes());
+}
+
+WeightMatrix& WeightMatrix::operator=(const WeightMatrix& other) {
+    if (this != &other) {
+        WeightMatrix tmp(other);
+        *this = std::move(tmp);
+    }
+    return *this;
+}
+
+WeightMatrix WeightMatrix::wrap(int rows, int cols, float* data, std::shared_ptr<void> owner) {
+    WeightMatrix m;
+    m.rows_ = rows;
+    m.cols_ = cols;
+    m.stride_ = paddedStride(cols);
+    m.ptr_ = data;
+    m.owner_ = std::move(owner);
+    return m;
+}
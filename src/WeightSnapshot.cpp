@@ -0,0 +1,66 @@
+#include "WeightSnapshot.hpp"
+#include <algorithm>
+#include <cstring>
+
+WeightSnapshot::WeightSnapshot(const WeightMatrix& weights)
+    : buffers_{weights, weights}, dirty_(weights.rows(), 0), pending_(weights.rows(), 0) {}
+
+void WeightSnapshot::markAllDirty() {
+    std::fill(dirty_.begin(), dirty_.end(), kAllFlags);
+}
+
+bool WeightSnapshot::publish(const WeightMatrix& weights) {
+    // el búfer trasero sólo lo usa este hilo: se copia sin bloquear
+    int back;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        back = 1 - front_;
+    }
+    uint8_t stale = static_cast<uint8_t>(1u << back);
+    WeightMatrix& target = buffers_[back];
+    std::size_t row_bytes = static_cast<std::size_t>(weights.stride()) * sizeof(float);
+    for (int i = 0; i < weights.rows(); i++) {
+        if (dirty_[i] & stale) {
+            std::memcpy(target.row(i), weights.row(i), row_bytes);
+            dirty_[i] &= static_cast<uint8_t>(~stale);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (reading_) return false;
+    for (int i = 0; i < weights.rows(); i++) {
+        if (dirty_[i] & kUnpublished) {
+            pending_[i] = 1;
+            dirty_[i] &= static_cast<uint8_t>(~kUnpublished);
+        }
+    }
+    front_ = back;
+    version_++;
+    fresh_ = true;
+    return true;
+}
+
+const WeightMatrix* WeightSnapshot::acquire(std::vector<int>& changed) {
+    changed.clear();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!fresh_) return nullptr;
+    for (int i = 0; i < static_cast<int>(pending_.size()); i++) {
+        if (pending_[i]) {
+            changed.push_back(i);
+            pending_[i] = 0;
+        }
+    }
+    fresh_ = false;
+    reading_ = true;
+    return &buffers_[front_];
+}
+
+void WeightSnapshot::release() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    reading_ = false;
+}
+
+int WeightSnapshot::version() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return version_;
+}
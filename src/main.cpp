@@ -1,38 +1,228 @@
+#include "GrowingSom.hpp"
 #include "KohonenNetwork.hpp"
 #include "MNISTLoader.hpp"
+#include "Profiler.hpp"
 #include "KohonenVisualizer.hpp"
+#include "SampleSource.hpp"
+#include "SomClassifier.hpp"
+#include <atomic>
+#include <cstdlib>
 #include <iostream>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#if __has_include(<GL/freeglut_ext.h>)
+#include <GL/freeglut_ext.h>
+#endif
 
 Kohonen3D* kohonenNet = nullptr;
 KohonenVisualizer* visualizer = nullptr;
+WeightSnapshot* snapshot = nullptr;
+std::thread* trainer = nullptr;
+// ESC (o cerrar la ventana, con freeglut) pide al hilo de entrenamiento que pare
+std::atomic<bool> stopTraining(false);
+// el hilo de entrenamiento ha terminado: la vista reajusta los prototipos
+std::atomic<bool> trainingFinished(false);
+
+// Intervalo de refresco de la vista mientras se entrena (ms)
+const int kRefreshMs = 33;
 
 void displayWrapper() { visualizer->renderScene(); }
 void reshapeWrapper(int w, int h) { visualizer->reshape(w, h); }
 void mouseWrapper(int btn, int state, int x, int y) { visualizer->onMouse(btn, state, x, y); }
 void motionWrapper(int x, int y) { visualizer->onMotion(x, y); }
-void keyboardWrapper(unsigned char key, int x, int y) { visualizer->onKeyboard(key, x, y); }
+
+// Para el entrenamiento, espera a que el hilo termine (incluido el guardado
+// en curso) y libera todo antes de salir.
+void shutdown() {
+    stopTraining = true;
+    if (trainer) {
+        trainer->join();
+        delete trainer;
+        trainer = nullptr;
+    }
+    delete visualizer;
+    delete snapshot;
+    delete kohonenNet;
+    visualizer = nullptr;
+    snapshot = nullptr;
+    kohonenNet = nullptr;
+}
+
+void keyboardWrapper(unsigned char key, int x, int y) {
+    if (key == 27) {
+        shutdown();
+        std::exit(0);
+    }
+    visualizer->onKeyboard(key, x, y);
+}
+
+// Tras entrenar con MNIST: etiqueta las neuronas con las muestras de
+// entrenamiento y mide la precisión sobre t10k si está en data/.
+void reportAccuracy(const std::vector<Vector>& images, const std::string& dataset_path) {
+    std::ifstream test_images(dataset_path + "t10k-images.idx3-ubyte");
+    if (!test_images.good()) return;
+    try {
+        std::vector<uint8_t> labels = MNISTDataset::loadLabelIndices(dataset_path + "train-labels.idx1-ubyte",
+                                                                     static_cast<int>(images.size()));
+        BatchMapper mapper(kohonenNet->getCodebook());
+        SomClassifier classifier(*kohonenNet);
+        classifier.fit(mapper.map(images), labels);
+
+        IdxSampleSource test(dataset_path + "t10k-images.idx3-ubyte");
+        std::vector<uint8_t> test_labels = MNISTDataset::loadLabelIndices(dataset_path + "t10k-labels.idx1-ubyte");
+        ClassificationReport report = classifier.evaluate(mapper.map(test), test_labels);
+        std::cout << "Precisión en t10k: " << report.accuracy * 100.0f << "%\n";
+    } catch (const std::exception& e) {
+        std::cerr << "No se pudo evaluar: " << e.what() << "\n";
+    }
+}
+
+std::vector<Vector> readAllSamples(SampleSource& source) {
+    std::vector<Vector> samples;
+    std::vector<float> block(static_cast<std::size_t>(1024) * source.dim());
+    while (int rows = source.read(block.data(), 1024)) {
+        for (int r = 0; r < rows; r++) {
+            const float* x = &block[static_cast<std::size_t>(r) * source.dim()];
+            samples.emplace_back(x, x + source.dim());
+        }
+    }
+    return samples;
+}
+
+// --grow: en lugar de la red fija de 10x10x10, la red empieza en 2x2x2 y
+// crece por planos mientras su error baje (GrowingSom con un solo nivel).
+Kohonen3D* growNetwork(const std::vector<Vector>& samples) {
+    GrowingOptions options;
+    options.maxDepth = 1;
+    options.maxNeuronsPerMap = 1000;
+    GrowingSom som(options);
+    som.train(samples);
+    const Kohonen3D& net = som.root();
+    std::cout << "Red crecida hasta " << net.getSizeX() << "x" << net.getSizeY() << "x" << net.getSizeZ() << " ("
+              << net.getNumNeurons() << " neuronas)\n";
+    return new Kohonen3D(net);
+}
+
+void refreshTimer(int) {
+    if (visualizer->updateFromSnapshot()) glutPostRedisplay();
+    if (trainingFinished.exchange(false)) {
+        visualizer->refitPrototypes();
+        glutPostRedisplay();
+    }
+    glutTimerFunc(kRefreshMs, refreshTimer, 0);
+}
 
 int main(int argc, char** argv) {
-    // Inicializar GLUT
+    // Inicializar GLUT (quita de argv sus propias opciones)
     glutInit(&argc, argv);
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH);
     glutInitWindowSize(1000, 800);
-    glutCreateWindow("Kohonen 3D con MNIST");
+    glutCreateWindow("Kohonen 3D");
+#ifdef GLUT_ACTION_ON_WINDOW_CLOSE
+    // sin esto freeglut llama a exit() al cerrar la ventana, con el
+    // entrenamiento o el guardado aún en marcha
+    glutSetOption(GLUT_ACTION_ON_WINDOW_CLOSE, GLUT_ACTION_GLUTMAINLOOP_RETURNS);
+#endif
 
-    // Cargar y entrenar red
+    // Sin argumentos se usa MNIST de data/; con un fichero de datos (IDX,
+    // CSV/TSV o float32 .f32) se entrena sobre él y el checkpoint se guarda
+    // a su lado. --shape indica la forma de las muestras cuando el fichero
+    // no la lleva (float32) o para reinterpretarla (p.ej. 32x32x3).
+    // --topology elige la topología de una red nueva (rect, torus o bcc); una red
+    // cargada del checkpoint conserva la suya. --grow ajusta el tamaño de la
+    // red a los datos (siempre rectangular) en lugar de usar 10x10x10.
+    std::string data_path;
+    SampleShape shape;
+    LatticeTopology topology = LatticeTopology::Rectangular;
+    bool grow = false;
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--shape" && i + 1 < argc) shape = SampleShape::parse(argv[++i]);
+            else if (arg == "--topology" && i + 1 < argc) topology = parseTopology(argv[++i]);
+            else if (arg == "--grow") grow = true;
+            else if (data_path.empty() && arg[0] != '-') data_path = arg;
+            else throw std::runtime_error("Unknown argument: " + arg);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n"
+                  << "Uso: " << argv[0] << " [datos] [--shape FORMA] [--topology rect|torus|bcc] [--grow]\n";
+        return 1;
+    }
+
+    // Cargar la red desde el checkpoint, o entrenarla y guardarla
     std::string dataset_path = "data/";
+    std::string checkpoint_path = data_path.empty() ? dataset_path + "kohonen3d.ckpt" : data_path + ".ckpt";
     int samples = 5000;
 
-    auto images = MNISTDataset::loadImages(dataset_path + "train-images.idx3-ubyte", samples);
-    auto labels = MNISTDataset::loadLabels(dataset_path + "train-labels.idx1-ubyte", samples);
-
-    kohonenNet = new Kohonen3D(10, 10, 10, 28 * 28);
-    kohonenNet->train(images, 1, 0.1f, 3.0f);
+    std::vector<Vector> images;
+    std::unique_ptr<SampleSource> source;
+    std::ifstream checkpoint(checkpoint_path);
+    try {
+        if (checkpoint.good()) {
+            kohonenNet = new Kohonen3D(Kohonen3D::loadCheckpoint(checkpoint_path));
+            std::cout << "Red cargada desde " << checkpoint_path << "\n";
+        } else if (data_path.empty()) {
+            images = MNISTDataset::loadImages(dataset_path + "train-images.idx3-ubyte", samples);
+            kohonenNet = new Kohonen3D(10, 10, 10, 28 * 28, topology);
+            shape = SampleShape::parse("28x28");
+        } else {
+            source = openSampleSource(data_path, shape);
+            if (shape.empty()) shape = source->shape();
+            kohonenNet = new Kohonen3D(10, 10, 10, source->dim(), topology);
+        }
+        if (grow && (!images.empty() || source)) {
+            if (source) {
+                images = readAllSamples(*source);
+                source.reset();
+            }
+            delete kohonenNet;
+            kohonenNet = growNetwork(images);
+            kohonenNet->saveCheckpoint(checkpoint_path);
+            std::cout << "Red guardada en " << checkpoint_path << "\n";
+            if (data_path.empty()) reportAccuracy(images, dataset_path);
+            images.clear();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
 
     visualizer = new KohonenVisualizer(kohonenNet);
+    if (!shape.empty()) visualizer->setSampleShape(shape);
     visualizer->initGL();
     visualizer->initNeurons();
 
+    // Sin checkpoint (y sin --grow, que ya entrena al crecer) se entrena en
+    // un hilo aparte mientras la ventana muestra la evolución de los prototipos
+    if (!images.empty() || source) {
+        snapshot = new WeightSnapshot(kohonenNet->getCodebook());
+        kohonenNet->setSnapshot(snapshot);
+        kohonenNet->setStopFlag(&stopTraining);
+        visualizer->setSnapshotSource(snapshot);
+        trainer = new std::thread([images = std::move(images), source = std::move(source), checkpoint_path, dataset_path]() {
+            if (source) kohonenNet->trainStream(*source, 1, 0.1f, 3.0f);
+            else kohonenNet->train(images, 1, 0.1f, 3.0f);
+            trainingFinished = true;
+            // una red a medias no se guarda: el checkpoint impediría volver a entrenarla
+            if (stopTraining) {
+                std::cout << "Entrenamiento interrumpido; la red no se guarda\n";
+                return;
+            }
+            kohonenNet->saveCheckpoint(checkpoint_path);
+            std::cout << "Red guardada en " << checkpoint_path << "\n";
+#if KOHONEN_PROFILE
+            Profiler::instance().report().print(std::cout);
+            Profiler::instance().writeChromeTrace(checkpoint_path + ".trace.json");
+            std::cout << "Traza guardada en " << checkpoint_path << ".trace.json\n";
+#endif
+            if (!images.empty()) reportAccuracy(images, dataset_path);
+        });
+        glutTimerFunc(kRefreshMs, refreshTimer, 0);
+    }
+
     glutDisplayFunc(displayWrapper);
     glutReshapeFunc(reshapeWrapper);
     glutMouseFunc(mouseWrapper);
@@ -41,7 +231,6 @@ int main(int argc, char** argv) {
 
     glutMainLoop();
 
-    delete visualizer;
-    delete kohonenNet;
+    shutdown();
     return 0;
 }
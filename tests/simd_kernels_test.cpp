@@ -0,0 +1,200 @@
+// Compara cada nivel SIMD disponible con el kernel escalar sobre codebooks
+// aleatorios cuyas columnas no llenan un registro (cols % 16 != 0), para
+// ejercitar las colas y las filas sobrantes de cada kernel.
+#include "BatchMapper.hpp"
+#include "BMUSearch.hpp"
+#include "UpdateKernel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond, ...)                                  \
+    do {                                                  \
+        if (!(cond)) {                                    \
+            std::printf("FALLO %s:%d: ", __FILE__, __LINE__); \
+            std::printf(__VA_ARGS__);                     \
+            std::printf("\n");                            \
+            failures++;                                   \
+        }                                                 \
+    } while (0)
+
+const int kRows[] = {1, 3, 5, 37, 130};
+const int kCols[] = {1, 3, 7, 17, 31, 45, 100, 785};
+
+bool close(float a, float b, float tolerance) {
+    return std::fabs(a - b) <= tolerance * std::max(1.0f, std::max(std::fabs(a), std::fabs(b)));
+}
+
+WeightMatrix randomCodebook(int rows, int cols, std::mt19937& rng) {
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    WeightMatrix codebook(rows, cols);
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) codebook.row(i)[j] = uniform(rng);
+    }
+    return codebook;
+}
+
+std::vector<float> randomVector(int cols, std::mt19937& rng) {
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    std::vector<float> x(cols);
+    for (float& v : x) v = uniform(rng);
+    return x;
+}
+
+float exactDistance(const WeightMatrix& codebook, int row, const float* x) {
+    double sum = 0.0;
+    for (int j = 0; j < codebook.cols(); j++) {
+        double diff = static_cast<double>(x[j]) - codebook.row(row)[j];
+        sum += diff * diff;
+    }
+    return static_cast<float>(sum);
+}
+
+// La ganadora debe coincidir salvo empate numérico: si difiere, su
+// distancia exacta tiene que ser la de la escalar.
+void checkWinner(const char* what, SimdLevel level, const WeightMatrix& codebook, const float* x, int expected,
+                 int got) {
+    if (expected == got) return;
+    float a = exactDistance(codebook, expected, x), b = exactDistance(codebook, got, x);
+    CHECK(close(a, b, 1e-5f), "%s %s %dx%d: BMU %d, escalar %d (%g frente a %g)", what,
+          BMUSearch::simdLevelName(level), codebook.rows(), codebook.cols(), got, expected, b, a);
+}
+
+void testBMUSearch(SimdLevel level, std::mt19937& rng) {
+    BMUSearch scalar(SimdLevel::Scalar), simd(level);
+    for (int rows : kRows) {
+        for (int cols : kCols) {
+            WeightMatrix codebook = randomCodebook(rows, cols, rng);
+            for (int trial = 0; trial < 8; trial++) {
+                std::vector<float> x = randomVector(cols, rng);
+                BMUResult a = scalar.find(codebook, x.data());
+                BMUResult b = simd.find(codebook, x.data());
+                checkWinner("BMUSearch", level, codebook, x.data(), a.index, b.index);
+                CHECK(close(a.distance, b.distance, 1e-4f), "BMUSearch %s %dx%d: distancia %g, escalar %g",
+                      BMUSearch::simdLevelName(level), rows, cols, b.distance, a.distance);
+                if (rows > 1) {
+                    CHECK(b.second >= 0 && b.second != b.index, "BMUSearch %s %dx%d: segunda %d",
+                          BMUSearch::simdLevelName(level), rows, cols, b.second);
+                    CHECK(close(a.secondDistance, b.secondDistance, 1e-4f),
+                          "BMUSearch %s %dx%d: segunda distancia %g, escalar %g", BMUSearch::simdLevelName(level),
+                          rows, cols, b.secondDistance, a.secondDistance);
+                }
+
+                // subrango que no empieza ni acaba en un múltiplo del bloque
+                int begin = rows / 3, end = rows - rows / 4;
+                a = scalar.find(codebook, x.data(), begin, end);
+                b = simd.find(codebook, x.data(), begin, end);
+                CHECK(b.index >= begin && b.index < end, "BMUSearch %s %dx%d: BMU %d fuera de [%d, %d)",
+                      BMUSearch::simdLevelName(level), rows, cols, b.index, begin, end);
+                checkWinner("BMUSearch (rango)", level, codebook, x.data(), a.index, b.index);
+
+                std::vector<uint8_t> bytes(cols);
+                for (int j = 0; j < cols; j++) bytes[j] = static_cast<uint8_t>(x[j] * 255.0f);
+                a = scalar.find(codebook, bytes.data(), 1.0f / 255.0f);
+                b = simd.find(codebook, bytes.data(), 1.0f / 255.0f);
+                CHECK(close(a.distance, b.distance, 1e-4f), "BMUSearch bytes %s %dx%d: distancia %g, escalar %g",
+                      BMUSearch::simdLevelName(level), rows, cols, b.distance, a.distance);
+            }
+        }
+    }
+}
+
+void testUpdateKernel(SimdLevel level, std::mt19937& rng) {
+    UpdateKernel scalar(SimdLevel::Scalar), simd(level);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    for (int rows : kRows) {
+        for (int cols : kCols) {
+            WeightMatrix reference = randomCodebook(rows, cols, rng);
+            WeightMatrix codebook = reference;
+            // listas de 1 a 9 vecinas: bloques de cuatro y filas sobrantes
+            for (int count = 1; count <= std::min(rows, 9); count += 2) {
+                std::vector<int> neurons(rows);
+                for (int i = 0; i < rows; i++) neurons[i] = i;
+                std::shuffle(neurons.begin(), neurons.end(), rng);
+                std::vector<NeighborUpdate> updates;
+                for (int k = 0; k < count; k++) updates.push_back({neurons[k], uniform(rng)});
+                std::vector<float> x = randomVector(cols, rng), next = randomVector(cols, rng);
+
+                BMUResult a = scalar.applyAndScore(reference, x.data(), updates.data(), count, next.data());
+                BMUResult b = simd.applyAndScore(codebook, x.data(), updates.data(), count, next.data());
+                for (int i = 0; i < rows; i++) {
+                    for (int j = 0; j < codebook.stride(); j++) {
+                        float u = reference.row(i)[j], v = codebook.row(i)[j];
+                        CHECK(close(u, v, 1e-6f), "UpdateKernel %s %dx%d: w[%d][%d] = %g, escalar %g",
+                              BMUSearch::simdLevelName(level), rows, cols, i, j, v, u);
+                        if (j >= cols) CHECK(v == 0.0f, "UpdateKernel %s %dx%d: relleno w[%d][%d] = %g",
+                                             BMUSearch::simdLevelName(level), rows, cols, i, j, v);
+                    }
+                }
+                checkWinner("UpdateKernel", level, codebook, next.data(), a.index, b.index);
+                CHECK(close(a.distance, b.distance, 1e-4f), "UpdateKernel %s %dx%d: distancia %g, escalar %g",
+                      BMUSearch::simdLevelName(level), rows, cols, b.distance, a.distance);
+
+                // seguir desde los mismos pesos: si no, las diferencias en el
+                // último bit se acumulan entre pasadas
+                codebook = reference;
+            }
+        }
+    }
+}
+
+// BatchMapper usa la forma expandida ||x||² - 2 x·w + ||w||² y recalcula las
+// dos mejores con la distancia exacta.
+void testBatchMapper(SimdLevel level, std::mt19937& rng) {
+    BMUSearch scalar(SimdLevel::Scalar);
+    for (int rows : kRows) {
+        for (int cols : kCols) {
+            WeightMatrix codebook = randomCodebook(rows, cols, rng);
+            std::vector<std::vector<float>> samples(67);
+            for (auto& x : samples) x = randomVector(cols, rng);
+            BatchMapper mapper(codebook, level);
+            MappingOptions options;
+            options.threads = 1;
+            options.sampleBlock = 8;
+            options.neuronBlock = 16;
+            std::vector<MappedSample> mapped = mapper.map(samples, options);
+            for (std::size_t s = 0; s < samples.size(); s++) {
+                BMUResult a = scalar.find(codebook, samples[s].data());
+                checkWinner("BatchMapper", level, codebook, samples[s].data(), a.index, mapped[s].bmu);
+                CHECK(close(std::sqrt(a.distance), mapped[s].quantizationError, 1e-4f),
+                      "BatchMapper %s %dx%d: error %g, escalar %g", BMUSearch::simdLevelName(level), rows, cols,
+                      mapped[s].quantizationError, std::sqrt(a.distance));
+                if (rows > 1) {
+                    CHECK(mapped[s].secondBmu >= 0 && mapped[s].secondBmu != mapped[s].bmu,
+                          "BatchMapper %s %dx%d: segunda %d", BMUSearch::simdLevelName(level), rows, cols,
+                          mapped[s].secondBmu);
+                } else {
+                    CHECK(mapped[s].secondBmu == -1, "BatchMapper %s 1x%d: segunda %d",
+                          BMUSearch::simdLevelName(level), cols, mapped[s].secondBmu);
+                }
+            }
+        }
+    }
+}
+
+}  // namespace
+
+int main() {
+    std::mt19937 rng(2024);
+    SimdLevel detected = BMUSearch::detectSimdLevel();
+    const SimdLevel levels[] = {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2, SimdLevel::AVX512};
+    for (SimdLevel level : levels) {
+        if (level > detected) break;
+        std::printf("%s\n", BMUSearch::simdLevelName(level));
+        testBMUSearch(level, rng);
+        testUpdateKernel(level, rng);
+        testBatchMapper(level, rng);
+    }
+    if (failures > 0) {
+        std::printf("%d comprobaciones fallidas\n", failures);
+        return 1;
+    }
+    std::printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,163 @@
+// Clasificación con un mapa entrenado: etiqueta las neuronas con los BMUs
+// del conjunto de entrenamiento y mide la precisión sobre el de test.
+//
+//   kohonen_classify data/kohonen3d.ckpt --threads 8
+//   kohonen_classify data/kohonen3d.ckpt --quantize int8
+
+#include "BatchMapper.hpp"
+#include "KohonenNetwork.hpp"
+#include "MNISTLoader.hpp"
+#include "QuantizedCodebook.hpp"
+#include "SampleSource.hpp"
+#include "SomClassifier.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+struct Options {
+    std::string checkpoint;
+    std::string trainImages = "data/train-images.idx3-ubyte";
+    std::string trainLabels = "data/train-labels.idx1-ubyte";
+    std::string testImages = "data/t10k-images.idx3-ubyte";
+    std::string testLabels = "data/t10k-labels.idx1-ubyte";
+    int trainSamples = -1;
+    int threads = 0;
+    bool confusion = false;
+    bool quantize = false;
+    QuantFormat format = QuantFormat::Int8;
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Uso: " << program << " <checkpoint> [opciones]\n"
+              << "  --train-images F     imágenes para etiquetar neuronas (data/train-images.idx3-ubyte)\n"
+              << "  --train-labels F     sus etiquetas (data/train-labels.idx1-ubyte)\n"
+              << "  --test-images F      imágenes de test (data/t10k-images.idx3-ubyte)\n"
+              << "  --test-labels F      sus etiquetas (data/t10k-labels.idx1-ubyte)\n"
+              << "  --train-samples N    usar sólo las N primeras muestras de entrenamiento\n"
+              << "  --threads N          hilos para la búsqueda de BMU (0 = todos)\n"
+              << "  --confusion          imprime la matriz de confusión\n"
+              << "  --quantize int8|fp16 compara además con el codebook cuantizado (QuantizedCodebook)\n";
+}
+
+Options parseArguments(int argc, char** argv) {
+    Options options;
+    auto value = [&](int& i) -> std::string {
+        if (i + 1 >= argc) throw std::runtime_error(std::string("Missing value for ") + argv[i]);
+        return argv[++i];
+    };
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--train-images") options.trainImages = value(i);
+        else if (arg == "--train-labels") options.trainLabels = value(i);
+        else if (arg == "--test-images") options.testImages = value(i);
+        else if (arg == "--test-labels") options.testLabels = value(i);
+        else if (arg == "--train-samples") options.trainSamples = std::atoi(value(i).c_str());
+        else if (arg == "--threads") options.threads = std::atoi(value(i).c_str());
+        else if (arg == "--confusion") options.confusion = true;
+        else if (arg == "--quantize") {
+            std::string format = value(i);
+            if (format == "int8") options.format = QuantFormat::Int8;
+            else if (format == "fp16") options.format = QuantFormat::Float16;
+            else throw std::runtime_error("Unknown quantization format: " + format);
+            options.quantize = true;
+        }
+        else if (!arg.empty() && arg[0] == '-') throw std::runtime_error("Unknown option: " + arg);
+        else if (options.checkpoint.empty()) options.checkpoint = arg;
+        else throw std::runtime_error("Unexpected argument: " + arg);
+    }
+    if (options.checkpoint.empty()) throw std::runtime_error("No checkpoint given");
+    return options;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Repite la evaluación con las BMUs del codebook cuantizado e imprime su
+// informe frente a fp32 y la diferencia de precisión.
+void reportQuantized(const Kohonen3D& net, QuantFormat format, const SomClassifier& classifier,
+                     const std::string& test_images, const std::vector<uint8_t>& test_labels,
+                     const ClassificationReport& fp32) {
+    QuantizedCodebook quantized(net, format);
+    IdxSampleSource test(test_images);
+    std::vector<Vector> samples;
+    std::vector<float> block(static_cast<std::size_t>(1024) * test.dim());
+    while (int rows = test.read(block.data(), 1024)) {
+        for (int r = 0; r < rows; r++) {
+            const float* x = &block[static_cast<std::size_t>(r) * test.dim()];
+            samples.emplace_back(x, x + test.dim());
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<MappedSample> mapped(samples.size());
+    for (std::size_t s = 0; s < samples.size(); s++) mapped[s] = {quantized.find(samples[s].data()), -1, 0.0f};
+    double seconds = secondsSince(start);
+    ClassificationReport report = classifier.evaluate(mapped, test_labels);
+
+    std::printf("\n%s:\n", format == QuantFormat::Int8 ? "int8" : "fp16");
+    quantized.compare(net, samples).print(std::cout);
+    std::printf("  Precisión: %.2f%% (%+.2f puntos frente a fp32)\n", report.accuracy * 100.0f,
+                (report.accuracy - fp32.accuracy) * 100.0f);
+    std::printf("  Test: %.3f s, %.0f muestras/s (un hilo)\n", seconds, samples.size() / seconds);
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        options = parseArguments(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    try {
+        Kohonen3D net = Kohonen3D::loadCheckpoint(options.checkpoint);
+        BatchMapper mapper(net.getCodebook());
+        MappingOptions mapping;
+        mapping.threads = options.threads;
+
+        auto start = std::chrono::steady_clock::now();
+        IdxSampleSource train(options.trainImages, 1.0f / 255.0f, options.trainSamples);
+        std::vector<uint8_t> train_labels = MNISTDataset::loadLabelIndices(options.trainLabels, static_cast<int>(train.sizeHint()));
+        SomClassifier classifier(net);
+        classifier.fit(mapper.map(train, mapping), train_labels);
+        std::cout << "Neuronas etiquetadas con " << train_labels.size() << " muestras en "
+                  << secondsSince(start) << " s\n";
+
+        start = std::chrono::steady_clock::now();
+        IdxSampleSource test(options.testImages);
+        std::vector<MappedSample> mapped = mapper.map(test, mapping);
+        std::vector<uint8_t> test_labels = MNISTDataset::loadLabelIndices(options.testLabels, static_cast<int>(test.sizeHint()));
+        ClassificationReport report = classifier.evaluate(mapped, test_labels);
+        double seconds = secondsSince(start);
+
+        std::printf("Precisión: %.2f%% (%d/%d)\n", report.accuracy * 100.0f, report.correct, report.samples);
+        std::printf("Test: %.3f s, %.0f muestras/s (%s)\n", seconds, report.samples / seconds,
+                    BMUSearch::simdLevelName(mapper.level()));
+        if (options.confusion) {
+            int classes = classifier.classes();
+            for (int real = 0; real < classes; real++) {
+                for (int predicted = 0; predicted < classes; predicted++) {
+                    std::printf("%6d", report.confusion[real * classes + predicted]);
+                }
+                std::printf("\n");
+            }
+        }
+        if (options.quantize) {
+            reportQuantized(net, options.format, classifier, options.testImages, test_labels, report);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
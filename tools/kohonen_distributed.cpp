@@ -0,0 +1,175 @@
+// Entrenamiento batch repartido entre varios procesos de la misma máquina
+// (sockets Unix, ver Transport.hpp). Cada proceso se queda con una de cada
+// N muestras; el rango 0 guarda el checkpoint con el mismo formato que el
+// visualizador, que lo abre al darle el mismo fichero de datos.
+//
+//   kohonen_distributed data/train-images.idx3-ubyte --procs 4 --epochs 10
+//
+// Con --rank, --world y --socket se lanza un único proceso de un grupo
+// arrancado a mano (p.ej. uno por terminal) en lugar de crear los demás.
+
+#include "KohonenNetwork.hpp"
+#include "SampleSource.hpp"
+#include "Transport.hpp"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+struct Options {
+    std::string data = "data/train-images.idx3-ubyte";
+    std::string output;
+    SampleShape shape;
+    LatticeTopology topology = LatticeTopology::Rectangular;
+    int size = 10;
+    int epochs = 10;
+    float learningRate = 0.5f;
+    float radius = 3.0f;
+    int threads = 1;
+    int processes = 2;
+    int rank = -1;            // >= 0: proceso suelto de un grupo lanzado a mano
+    int world = 0;
+    std::string socket;
+    int timeoutSeconds = 600;  // sin noticias de otro proceso; < 0 sin límite
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Uso: " << program << " [datos] [opciones]\n"
+              << "  --procs N            procesos locales a lanzar (2)\n"
+              << "  --size L             red de LxLxL neuronas (10)\n"
+              << "  --topology T         rect, torus o bcc (rect)\n"
+              << "  --epochs N           épocas batch (10)\n"
+              << "  --lr A --radius R    tasa y radio iniciales (0.5, 3)\n"
+              << "  --threads N          hilos por proceso (1; 0 = todos)\n"
+              << "  --shape FORMA        forma de las muestras (float32 crudo)\n"
+              << "  --out F              checkpoint (datos + .ckpt; data/kohonen3d.ckpt para MNIST)\n"
+              << "  --timeout S          segundos sin respuesta de otro proceso antes de abortar (600)\n"
+              << "  --rank R --world N --socket PREFIJO\n"
+              << "                       un solo proceso de un grupo lanzado a mano\n";
+}
+
+Options parseArguments(int argc, char** argv) {
+    Options options;
+    bool data_given = false;
+    auto value = [&](int& i) -> std::string {
+        if (i + 1 >= argc) throw std::runtime_error(std::string("Missing value for ") + argv[i]);
+        return argv[++i];
+    };
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--procs") options.processes = std::atoi(value(i).c_str());
+        else if (arg == "--size") options.size = std::atoi(value(i).c_str());
+        else if (arg == "--topology") options.topology = parseTopology(value(i));
+        else if (arg == "--epochs") options.epochs = std::atoi(value(i).c_str());
+        else if (arg == "--lr") options.learningRate = std::strtof(value(i).c_str(), nullptr);
+        else if (arg == "--radius") options.radius = std::strtof(value(i).c_str(), nullptr);
+        else if (arg == "--threads") options.threads = std::atoi(value(i).c_str());
+        else if (arg == "--shape") options.shape = SampleShape::parse(value(i));
+        else if (arg == "--out") options.output = value(i);
+        else if (arg == "--rank") options.rank = std::atoi(value(i).c_str());
+        else if (arg == "--world") options.world = std::atoi(value(i).c_str());
+        else if (arg == "--socket") options.socket = value(i);
+        else if (arg == "--timeout") options.timeoutSeconds = std::atoi(value(i).c_str());
+        else if (!arg.empty() && arg[0] == '-') throw std::runtime_error("Unknown option: " + arg);
+        else if (!data_given) {
+            options.data = arg;
+            data_given = true;
+        } else {
+            throw std::runtime_error("Unexpected argument: " + arg);
+        }
+    }
+    // mismo checkpoint que buscaría kohonen_visualizer con estos datos
+    if (options.output.empty()) options.output = data_given ? options.data + ".ckpt" : "data/kohonen3d.ckpt";
+    if (options.rank >= 0 && (options.world < 1 || options.rank >= options.world || options.socket.empty())) {
+        throw std::runtime_error("--rank needs --world N (> rank) and --socket");
+    }
+    if (options.rank < 0 && options.processes < 1) throw std::runtime_error("--procs must be at least 1");
+    if (options.size < 1 || options.epochs < 1) throw std::runtime_error("Invalid network size or epochs");
+    return options;
+}
+
+// Muestras rank, rank + world, rank + 2 world...: una sola pasada y sin
+// conocer antes el total.
+std::vector<Vector> readShard(SampleSource& source, int rank, int world) {
+    std::vector<Vector> shard;
+    std::vector<float> block(static_cast<std::size_t>(1024) * source.dim());
+    long long index = 0;
+    while (int rows = source.read(block.data(), 1024)) {
+        for (int r = 0; r < rows; r++, index++) {
+            if (index % world != rank) continue;
+            const float* x = &block[static_cast<std::size_t>(r) * source.dim()];
+            shard.emplace_back(x, x + source.dim());
+        }
+    }
+    return shard;
+}
+
+int runProcess(const Options& options, int rank, int world, const std::string& socket) {
+    try {
+        std::unique_ptr<SampleSource> source = openSampleSource(options.data, options.shape);
+        std::vector<Vector> shard = readShard(*source, rank, world);
+        int io_timeout_ms = options.timeoutSeconds < 0 ? -1 : std::min(options.timeoutSeconds, INT_MAX / 1000) * 1000;
+        UnixSocketTransport transport(socket, rank, world, 30000, io_timeout_ms);
+
+        // la red inicial del rango 0 se reparte a los demás
+        Kohonen3D net(options.size, options.size, options.size, source->dim(), options.topology);
+        DistributedOptions distributed;
+        distributed.threads = options.threads;
+        auto start = std::chrono::steady_clock::now();
+        net.trainDistributed(shard, options.epochs, options.learningRate, options.radius, transport, distributed);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (rank == 0) {
+            net.saveCheckpoint(options.output);
+            std::cout << world << " procesos, " << seconds << " s. Red guardada en " << options.output << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error (rango " << rank << "): " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        options = parseArguments(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    if (options.rank >= 0) return runProcess(options, options.rank, options.world, options.socket);
+
+    // lanzador local: el proceso actual es el rango 0
+    std::string socket = "/tmp/kohonen-" + std::to_string(::getpid());
+    std::vector<pid_t> children;
+    for (int rank = 1; rank < options.processes; rank++) {
+        std::cout.flush();
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            std::cerr << "Cannot fork worker process\n";
+            return 1;
+        }
+        if (pid == 0) ::_exit(runProcess(options, rank, options.processes, socket));
+        children.push_back(pid);
+    }
+    int status = runProcess(options, 0, options.processes, socket);
+    for (pid_t pid : children) {
+        int child_status = 0;
+        if (::waitpid(pid, &child_status, 0) < 0 || !WIFEXITED(child_status) || WEXITSTATUS(child_status) != 0) {
+            status = 1;
+        }
+    }
+    return status;
+}
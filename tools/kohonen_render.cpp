@@ -0,0 +1,148 @@
+// Render sin ventana de un checkpoint de Kohonen3D: fotogramas PNG de la red
+// en 3D a lo largo de un recorrido de cámara y vistas 2D (matriz U y planos
+// de componente). No usa OpenGL, así que funciona en nodos sin display.
+//
+//   kohonen_render data/kohonen3d.ckpt -o frames --frames 120 --umatrix
+
+#include "CameraPath.hpp"
+#include "KohonenNetwork.hpp"
+#include "MapExport.hpp"
+#include "PngWriter.hpp"
+#include "PrototypeImage.hpp"
+#include "SoftwareRenderer.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string checkpoint;
+    std::string outputDir = ".";
+    std::string prefix;
+    std::string cameraFile;
+    std::string shape;
+    int width = 1000;
+    int height = 800;
+    int frames = 1;
+    int cellSize = 8;
+    bool umatrix = false;
+    std::string components;
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Uso: " << program << " <checkpoint> [opciones]\n"
+              << "  -o, --output DIR     directorio de salida (por defecto .)\n"
+              << "  --prefix NOMBRE      prefijo de los ficheros generados\n"
+              << "  --size AxB           tamaño de los fotogramas (1000x800)\n"
+              << "  --shape FORMA        forma de las muestras (p.ej. 28x28, 32x32x3, 256)\n"
+              << "  --frames N           órbita completa de N fotogramas (1; 0 = ninguno)\n"
+              << "  --camera FICHERO     recorrido de cámara (frame zoom angleX angleY [fovY])\n"
+              << "  --umatrix            exporta la matriz U\n"
+              << "  --components LISTA   planos de componente: 'all' o índices separados por comas\n"
+              << "  --cell N             píxeles por neurona en las vistas 2D (8)\n";
+}
+
+Options parseArguments(int argc, char** argv) {
+    Options options;
+    auto value = [&](int& i) -> std::string {
+        if (i + 1 >= argc) throw std::runtime_error(std::string("Missing value for ") + argv[i]);
+        return argv[++i];
+    };
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-o" || arg == "--output") options.outputDir = value(i);
+        else if (arg == "--prefix") options.prefix = value(i);
+        else if (arg == "--camera") options.cameraFile = value(i);
+        else if (arg == "--shape") options.shape = value(i);
+        else if (arg == "--frames") options.frames = std::atoi(value(i).c_str());
+        else if (arg == "--cell") options.cellSize = std::atoi(value(i).c_str());
+        else if (arg == "--umatrix") options.umatrix = true;
+        else if (arg == "--components") options.components = value(i);
+        else if (arg == "--size") {
+            std::string size = value(i);
+            if (std::sscanf(size.c_str(), "%dx%d", &options.width, &options.height) != 2) {
+                throw std::runtime_error("Invalid size: " + size);
+            }
+        } else if (!arg.empty() && arg[0] == '-') {
+            throw std::runtime_error("Unknown option: " + arg);
+        } else if (options.checkpoint.empty()) {
+            options.checkpoint = arg;
+        } else {
+            throw std::runtime_error("Unexpected argument: " + arg);
+        }
+    }
+    if (options.checkpoint.empty()) throw std::runtime_error("No checkpoint given");
+    return options;
+}
+
+std::vector<int> parseComponents(const std::string& list, int input_dim) {
+    std::vector<int> components;
+    if (list == "all") {
+        for (int j = 0; j < input_dim; j++) components.push_back(j);
+        return components;
+    }
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) components.push_back(std::atoi(item.c_str()));
+    }
+    return components;
+}
+
+std::string numbered(const std::string& base, int n) {
+    char digits[16];
+    std::snprintf(digits, sizeof(digits), "%04d", n);
+    return base + digits + ".png";
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        options = parseArguments(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    try {
+        Kohonen3D net = Kohonen3D::loadCheckpoint(options.checkpoint);
+        std::string base = options.outputDir + "/" + options.prefix;
+
+        CameraPath path = options.cameraFile.empty()
+            ? CameraPath::orbit(Camera(), options.frames)
+            : CameraPath::load(options.cameraFile);
+        if (options.frames > 0) {
+            SampleShape shape = options.shape.empty() ? SampleShape::guess(net.getInputDim())
+                                                      : SampleShape::parse(options.shape);
+            SoftwareRenderer renderer(options.width, options.height);
+            renderer.setNetwork(net, *makePrototypeRenderer(shape, net.getCodebook()));
+            for (int f = 0; f < path.frameCount(); f++) {
+                const auto& pixels = renderer.render(path.frame(f));
+                writePNG(numbered(base + "frame_", f), renderer.width(), renderer.height(), 3, pixels.data());
+            }
+            std::cout << path.frameCount() << " fotogramas en " << options.outputDir << "\n";
+        }
+
+        int sx = net.getSizeX(), sy = net.getSizeY(), sz = net.getSizeZ();
+        if (options.umatrix) {
+            writeMapImage(base + "umatrix.png", renderSlices(computeUMatrix(net), sx, sy, sz, options.cellSize));
+        }
+        for (int j : parseComponents(options.components, net.getInputDim())) {
+            writeMapImage(numbered(base + "component_", j),
+                          renderSlices(componentPlane(net, j), sx, sy, sz, options.cellSize));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}